@@ -38,9 +38,9 @@ namespace graphene { namespace api {
 #ifndef IS_LOW_MEM
         auto& content = db.get_content_type(o.id);
 
-        title = to_string(content.title);
-        body = to_string(content.body);
-        json_metadata = to_string(content.json_metadata);
+        title = db.get_content_title(content);
+        body = db.get_content_body(content);
+        json_metadata = db.get_content_json_metadata(content);
 #endif
     }
 
@@ -66,6 +66,8 @@ namespace graphene { namespace api {
 
         void set_pending_payout(discussion& d) const;
 
+        void fill_pending_payout(discussion& d) const;
+
         void set_url(discussion& d) const;
 
         graphene::chain::database& database() {
@@ -78,6 +80,8 @@ namespace graphene { namespace api {
 
         discussion get_discussion(const content_object& c, uint32_t vote_limit) const;
 
+        discussion get_thread_discussion(const content_object& c, const discussion& root, uint32_t vote_limit) const;
+
     private:
         graphene::chain::database& database_;
     };
@@ -94,6 +98,30 @@ namespace graphene { namespace api {
     discussion discussion_helper::get_discussion(const content_object& c, uint32_t vote_limit) const {
         return pimpl->get_discussion(c, vote_limit);
     }
+
+    discussion discussion_helper::impl::get_thread_discussion(
+        const content_object& c, const discussion& root, uint32_t vote_limit
+    ) const {
+        discussion d = create_discussion(c);
+        fill_pending_payout(d);
+
+        d.root_title = root.title;
+        d.url = "/@" + root.author + "/" + root.permlink;
+        if (root.id != d.id) {
+            d.url += "#@" + d.author + "/" + d.permlink;
+        }
+
+        if (vote_limit > 0) {
+            select_active_votes(d.active_votes, d.active_votes_count, d.author, d.permlink, vote_limit);
+        }
+        return d;
+    }
+
+    discussion discussion_helper::get_thread_discussion(
+        const content_object& c, const discussion& root, uint32_t vote_limit
+    ) const {
+        return pimpl->get_thread_discussion(c, root, vote_limit);
+    }
 //
 
 // select_active_votes
@@ -129,6 +157,11 @@ namespace graphene { namespace api {
 //
 // set_pending_payout
     void discussion_helper::impl::set_pending_payout(discussion& d) const {
+        fill_pending_payout(d);
+        set_url(d);
+    }
+
+    void discussion_helper::impl::fill_pending_payout(discussion& d) const {
         auto& db = database();
 
         const auto& props = db.get_dynamic_global_properties();
@@ -161,8 +194,6 @@ namespace graphene { namespace api {
         if (d.parent_author.size() > 0 && d.body.size() > 1024 * 16) {
             d.body = "content pruned due to size";
         }
-
-        set_url(d);
     }
 
     void discussion_helper::set_pending_payout(discussion& d) const {
@@ -31,6 +31,12 @@ namespace graphene { namespace api {
 
         discussion get_discussion(const content_object& c, uint32_t vote_limit) const;
 
+        /**
+         *  Same as get_discussion for a content of an already known thread: url and root title
+         *  are taken from root, and votes are selected only if vote_limit is not zero
+         */
+        discussion get_thread_discussion(const content_object& c, const discussion& root, uint32_t vote_limit) const;
+
     private:
         struct impl;
         std::unique_ptr<impl> pimpl;
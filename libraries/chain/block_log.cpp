@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <graphene/chain/block_log.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
@@ -16,11 +17,14 @@ namespace graphene { namespace chain {
         public:
             optional<signed_block> head;
             block_id_type head_id;
+            uint32_t first_block_num = 1;
 
             std::string block_path;
             std::string index_path;
+            std::string ids_path;
             boost::iostreams::mapped_file block_mapped_file;
             boost::iostreams::mapped_file index_mapped_file;
+            boost::iostreams::mapped_file ids_mapped_file;
             read_write_mutex mutex;
 
             bool has_block_records() const {
@@ -63,13 +67,23 @@ namespace graphene { namespace chain {
             uint64_t get_block_pos(uint32_t block_num) const {
                 if (head.valid() &&
                     block_num <= protocol::block_header::num_from_id(head_id) &&
-                    block_num > 0
+                    block_num >= first_block_num
                 ) {
-                    return get_uint64(index_mapped_file, sizeof(uint64_t) * (block_num - 1));
+                    return get_uint64(index_mapped_file, sizeof(uint64_t) * (block_num - first_block_num));
                 }
                 return block_log::npos;
             }
 
+            block_id_type read_block_id(uint32_t block_num) const {
+                block_id_type result;
+                if (get_block_pos(block_num) != block_log::npos) {
+                    const auto pos = sizeof(block_id_type) * (block_num - first_block_num);
+                    FC_ASSERT(get_mapped_size(ids_mapped_file) >= pos + sizeof(block_id_type));
+                    std::memcpy(result.data(), ids_mapped_file.data() + pos, sizeof(block_id_type));
+                }
+                return result;
+            }
+
             uint64_t read_block(uint64_t pos, signed_block& block) const {
                 const auto file_size = get_mapped_size(block_mapped_file);
                 FC_ASSERT(file_size > pos);
@@ -87,6 +101,32 @@ namespace graphene { namespace chain {
                 return end_pos + sizeof(uint64_t);
             }
 
+            /**
+             * Returns the position and the packed size of the block, the block ends where
+             * the position trailer (of the next block or of the head block) starts
+             */
+            std::pair<uint64_t, uint64_t> get_serialized_block_span(uint32_t block_num) const {
+                const auto pos = get_block_pos(block_num);
+                FC_ASSERT(pos != block_log::npos, "Block ${num} is not in block log", ("num", block_num));
+
+                uint64_t end_pos;
+                if (block_num < protocol::block_header::num_from_id(head_id)) {
+                    end_pos = get_block_pos(block_num + 1) - sizeof(uint64_t);
+                } else {
+                    end_pos = get_mapped_size(block_mapped_file) - sizeof(uint64_t);
+                }
+                FC_ASSERT(end_pos > pos && get_uint64(block_mapped_file, end_pos) == pos);
+                return std::make_pair(pos, end_pos - pos);
+            }
+
+            uint32_t read_first_block_num() const {
+                const auto max_header_size = std::min<std::size_t>(get_mapped_size(block_mapped_file), CHAIN_BLOCK_SIZE);
+                fc::datastream<const char*> ds(block_mapped_file.data(), max_header_size);
+                signed_block_header header;
+                fc::raw::unpack(ds, header);
+                return header.block_num();
+            }
+
             signed_block read_head() const {
                 auto pos = get_last_uint64(block_mapped_file);
                 signed_block block;
@@ -112,12 +152,47 @@ namespace graphene { namespace chain {
                 index_mapped_file.open(index_path, boost::iostreams::mapped_file::readwrite);
             }
 
+            void open_ids_mapped_file() {
+                create_nonexist_file(ids_path);
+                ids_mapped_file.open(ids_path, boost::iostreams::mapped_file::readwrite);
+            }
+
+            bool is_ids_index_valid() const {
+                const auto head_num = protocol::block_header::num_from_id(head_id);
+                const auto size = sizeof(block_id_type) * (head_num - first_block_num + 1);
+                return get_mapped_size(ids_mapped_file) == size &&
+                       std::memcmp(ids_mapped_file.data() + size - sizeof(block_id_type),
+                                   head_id.data(), sizeof(block_id_type)) == 0;
+            }
+
+            void construct_ids_index() {
+                ilog("Reconstructing Block Log Id Index...");
+                ids_mapped_file.close();
+                boost::filesystem::remove_all(ids_path);
+                open_ids_mapped_file();
+                const auto head_num = protocol::block_header::num_from_id(head_id);
+                ids_mapped_file.resize((head_num - first_block_num + 1) * sizeof(block_id_type));
+
+                // the header is at the start of the packed block, there's no need to unpack transactions
+                auto* ids_ptr = ids_mapped_file.data();
+                for (uint32_t block_num = first_block_num; block_num <= head_num; ++block_num) {
+                    const auto pos = get_block_pos(block_num);
+                    const auto max_header_size = std::min<std::size_t>(get_mapped_size(block_mapped_file) - pos, CHAIN_BLOCK_SIZE);
+                    fc::datastream<const char*> ds(block_mapped_file.data() + pos, max_header_size);
+                    signed_block_header header;
+                    fc::raw::unpack(ds, header);
+                    const auto id = header.id();
+                    std::memcpy(ids_ptr, id.data(), sizeof(block_id_type));
+                    ids_ptr += sizeof(block_id_type);
+                }
+            }
+
             void construct_index() {
                 ilog("Reconstructing Block Log Index...");
                 index_mapped_file.close();
                 boost::filesystem::remove_all(index_path);
                 open_index_mapped_file();
-                index_mapped_file.resize(head->block_num() * sizeof(uint64_t));
+                index_mapped_file.resize((head->block_num() - first_block_num + 1) * sizeof(uint64_t));
 
                 uint64_t pos = 0;
                 uint64_t end_pos = get_last_uint64(block_mapped_file);
@@ -134,12 +209,16 @@ namespace graphene { namespace chain {
             void open(const fc::path& file) { try {
                 block_mapped_file.close();
                 index_mapped_file.close();
+                ids_mapped_file.close();
+                first_block_num = 1;
 
                 block_path = file.string();
                 index_path = boost::filesystem::path(file.string() + ".index").string();
+                ids_path = boost::filesystem::path(file.string() + ".ids").string();
 
                 open_block_mapped_file();
                 open_index_mapped_file();
+                open_ids_mapped_file();
 
                 /* On startup of the block log, there are several states the log file and the index file can be
                  * in relation to each other.
@@ -162,6 +241,7 @@ namespace graphene { namespace chain {
 
                 if (has_block_records()) {
                     ilog("Log is nonempty");
+                    first_block_num = read_first_block_num();
                     head = read_head();
                     head_id = head->id();
 
@@ -179,27 +259,40 @@ namespace graphene { namespace chain {
                         ilog("Index is empty");
                         construct_index();
                     }
-                } else if (has_index_records()) {
+
+                    if (!is_ids_index_valid()) {
+                        construct_ids_index();
+                    }
+                } else if (has_index_records() || get_mapped_size(ids_mapped_file)) {
                     ilog("Index is nonempty, remove and recreate it");
                     index_mapped_file.close();
                     block_mapped_file.close();
+                    ids_mapped_file.close();
 
                     boost::filesystem::remove_all(block_path);
                     boost::filesystem::remove_all(index_path);
+                    boost::filesystem::remove_all(ids_path);
 
                     open_block_mapped_file();
                     open_index_mapped_file();
+                    open_ids_mapped_file();
                 }
             } FC_LOG_AND_RETHROW() }
 
             uint64_t append(const signed_block& b, const std::vector<char>& data) { try {
                 const auto index_pos = get_mapped_size(index_mapped_file);
 
+                // an empty log can be started from any block, e.g. from the block of a state snapshot
+                if (!head.valid()) {
+                    FC_ASSERT(index_pos == 0, "Append to empty block log with nonempty index file.");
+                    first_block_num = b.block_num();
+                }
+
                 FC_ASSERT(
-                    index_pos == sizeof(uint64_t) * (b.block_num() - 1),
+                    index_pos == sizeof(uint64_t) * (b.block_num() - first_block_num),
                     "Append to index file occuring at wrong position.",
                     ("position", index_pos)
-                    ("expected", (b.block_num() - 1) * sizeof(uint64_t)));
+                    ("expected", (b.block_num() - first_block_num) * sizeof(uint64_t)));
 
                 uint64_t block_pos = get_mapped_size(block_mapped_file);
 
@@ -213,16 +306,28 @@ namespace graphene { namespace chain {
                 ptr = index_mapped_file.data() + index_pos;
                 *reinterpret_cast<uint64_t*>(ptr) = block_pos;
 
+                const auto id = b.id();
+                const auto ids_pos = sizeof(block_id_type) * (b.block_num() - first_block_num);
+                FC_ASSERT(
+                    get_mapped_size(ids_mapped_file) == ids_pos,
+                    "Append to id index file occuring at wrong position.",
+                    ("position", get_mapped_size(ids_mapped_file))
+                    ("expected", ids_pos));
+                ids_mapped_file.resize(ids_pos + sizeof(block_id_type));
+                std::memcpy(ids_mapped_file.data() + ids_pos, id.data(), sizeof(block_id_type));
+
                 head = b;
-                head_id = b.id();
+                head_id = id;
                 return block_pos;
             } FC_LOG_AND_RETHROW() }
 
             void close() {
                 block_mapped_file.close();
                 index_mapped_file.close();
+                ids_mapped_file.close();
                 head.reset();
                 head_id = block_id_type();
+                first_block_num = 1;
             }
         };
     }
@@ -256,6 +361,11 @@ namespace graphene { namespace chain {
         return my->append(block, data);
     } FC_LOG_AND_RETHROW() }
 
+    uint64_t block_log::append(const signed_block& block, const std::vector<char>& packed) { try {
+        detail::write_lock lock(my->mutex);
+        return my->append(block, packed);
+    } FC_LOG_AND_RETHROW() }
+
     void block_log::flush() {
         // it isn't needed, because all data is already in page cache
     }
@@ -284,11 +394,67 @@ namespace graphene { namespace chain {
         return result;
     } FC_LOG_AND_RETHROW() }
 
+    std::vector<char> block_log::read_serialized_block_by_num(uint32_t block_num) const { try {
+        detail::read_lock lock(my->mutex);
+        std::vector<char> result;
+        if (my->get_block_pos(block_num) != npos) {
+            auto span = my->get_serialized_block_span(block_num);
+            const auto* ptr = my->block_mapped_file.data() + span.first;
+            result.assign(ptr, ptr + span.second);
+        }
+        return result;
+    } FC_LOG_AND_RETHROW() }
+
+    optional<signed_block_header> block_log::read_block_header_by_num(uint32_t block_num) const { try {
+        detail::read_lock lock(my->mutex);
+        optional<signed_block_header> result;
+        if (my->get_block_pos(block_num) != npos) {
+            // a packed block starts with its packed header
+            auto span = my->get_serialized_block_span(block_num);
+            fc::datastream<const char*> ds(my->block_mapped_file.data() + span.first, span.second);
+            signed_block_header header;
+            fc::raw::unpack(ds, header);
+            result = std::move(header);
+        }
+        return result;
+    } FC_LOG_AND_RETHROW() }
+
+    std::vector<std::vector<char>> block_log::read_serialized_blocks(
+        uint32_t first_block_num, uint32_t count, uint64_t max_total_size
+    ) const { try {
+        detail::read_lock lock(my->mutex);
+        std::vector<std::vector<char>> result;
+        uint64_t total_size = 0;
+        for (uint32_t block_num = first_block_num; result.size() < count; ++block_num) {
+            if (my->get_block_pos(block_num) == npos) {
+                break;
+            }
+            auto span = my->get_serialized_block_span(block_num);
+            if (total_size + span.second > max_total_size) {
+                break;
+            }
+            total_size += span.second;
+            const auto* ptr = my->block_mapped_file.data() + span.first;
+            result.emplace_back(ptr, ptr + span.second);
+        }
+        return result;
+    } FC_LOG_AND_RETHROW() }
+
+    block_id_type block_log::read_block_id_by_num(uint32_t block_num) const { try {
+        detail::read_lock lock(my->mutex);
+        return my->read_block_id(block_num);
+    } FC_LOG_AND_RETHROW() }
+
     uint64_t block_log::get_block_pos(uint32_t block_num) const {
         detail::read_lock lock(my->mutex);
         return my->get_block_pos(block_num);
     }
 
+    uint32_t block_log::first_block_num() const {
+        detail::read_lock lock(my->mutex);
+        return my->first_block_num;
+    }
+
     signed_block block_log::read_head() const {
         detail::read_lock lock(my->mutex);
         return my->read_head();
@@ -325,12 +325,14 @@ namespace graphene { namespace chain {
                             com.parent_author = "";
                             from_string(com.parent_permlink, o.parent_permlink);
                             com.root_content = com.id;
+                            com.parent_content = com.id;
                         }
                         else {
                             com.parent_author = parent->author;
                             com.parent_permlink = parent->permlink;
                             com.depth = parent->depth + 1;
                             com.root_content = parent->root_content;
+                            com.parent_content = parent->id;
                         }
                     });
 
@@ -342,12 +344,12 @@ namespace graphene { namespace chain {
 #ifndef IS_LOW_MEM
                     _db.create<content_type_object>([&](content_type_object& con) {
                         con.content = id;
-                        from_string(con.title, o.title);
+                        _db.set_content_text(con.title, con.title_blob, o.title);
                         if (o.body.size() < 1024*1024*128) {
-                            from_string(con.body, o.body);
+                            _db.set_content_text(con.body, con.body_blob, o.body);
                         }
                         if (fc::is_utf8(o.json_metadata)) {
-                            from_string(con.json_metadata, o.json_metadata);
+                            _db.set_content_text(con.json_metadata, con.json_metadata_blob, o.json_metadata);
                         } else {
                             wlog("Content ${a}/${p} contains invalid UTF-8 metadata",
                                  ("a", o.author)("p", o.permlink));
@@ -397,11 +399,11 @@ namespace graphene { namespace chain {
 #ifndef IS_LOW_MEM
                     _db.modify(_db.get< content_type_object, by_content >( content.id ), [&]( content_type_object& con ) {
                         if (o.title.size())
-                            from_string(con.title, o.title);
+                            _db.set_content_text(con.title, con.title_blob, o.title);
                         if (o.json_metadata.size())
-                            from_string(con.json_metadata, o.json_metadata );
+                            _db.set_content_text(con.json_metadata, con.json_metadata_blob, o.json_metadata);
                         if (o.body.size())
-                            from_string(con.body, o.body);
+                            _db.set_content_text(con.body, con.body_blob, o.body);
                     });
 #endif
 
@@ -0,0 +1,205 @@
+#include <graphene/chain/content_body_store.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+
+namespace graphene { namespace chain {
+    namespace detail {
+        using read_write_mutex = boost::shared_mutex;
+        using read_lock = boost::shared_lock<read_write_mutex>;
+        using write_lock = boost::unique_lock<read_write_mutex>;
+        using text_size_type = uint32_t;
+        static constexpr uint64_t header_size = sizeof(uint64_t);
+        static constexpr uint64_t min_grow_size = 16 * 1024 * 1024;
+        static constexpr size_t max_recent_texts = 16384;
+
+        class content_body_store_impl {
+        public:
+            std::string path;
+            boost::iostreams::mapped_file mapped_file;
+            read_write_mutex mutex;
+
+            // the same operation is evaluated on push of a transaction, on reapply of pending ones,
+            // on generation and on application of a block, so recent texts are appended only once
+            std::map<fc::sha256, uint64_t> recent_handles;
+            std::deque<fc::sha256> recent_order;
+
+            uint64_t get_end() const {
+                return *reinterpret_cast<const uint64_t*>(mapped_file.const_data());
+            }
+
+            void set_end(uint64_t end) {
+                *reinterpret_cast<uint64_t*>(mapped_file.data()) = end;
+            }
+
+            void create_nonexist_file() const {
+                if (!boost::filesystem::is_regular_file(path) || boost::filesystem::file_size(path) < header_size) {
+                    std::ofstream stream(path, std::ios::out|std::ios::binary|std::ios::trunc);
+                    const uint64_t end = header_size;
+                    stream.write(reinterpret_cast<const char*>(&end), sizeof(end));
+                    stream.close();
+                }
+            }
+
+            void open(const fc::path& file) { try {
+                mapped_file.close();
+                recent_handles.clear();
+                recent_order.clear();
+                path = file.string();
+                create_nonexist_file();
+                mapped_file.open(path, boost::iostreams::mapped_file::readwrite);
+
+                const auto end = get_end();
+                FC_ASSERT(end >= header_size && end <= mapped_file.size(),
+                    "Content body store ${path} is corrupted, replay is required", ("path", path));
+            } FC_LOG_AND_RETHROW() }
+
+            void reserve(uint64_t size) {
+                const auto end = get_end();
+                if (end + size <= mapped_file.size()) {
+                    return;
+                }
+                // texts are small, so the file grows by chunks to avoid remapping it on each append
+                const auto new_size = std::max(end + size, mapped_file.size() + std::max(min_grow_size, mapped_file.size() / 2));
+                mapped_file.resize(new_size);
+            }
+
+            bool is_stored_text(uint64_t handle, const std::string& text) const {
+                text_size_type size;
+                const auto* ptr = mapped_file.const_data() + handle;
+                std::memcpy(&size, ptr, sizeof(size));
+                return size == text.size() && std::memcmp(ptr + sizeof(size), text.data(), size) == 0;
+            }
+
+            void remember(const fc::sha256& hash, uint64_t handle) {
+                if (recent_order.size() >= max_recent_texts) {
+                    recent_handles.erase(recent_order.front());
+                    recent_order.pop_front();
+                }
+                recent_handles[hash] = handle;
+                recent_order.push_back(hash);
+            }
+
+            uint64_t append(const std::string& text) {
+                FC_ASSERT(text.size() <= std::numeric_limits<text_size_type>::max(), "Text is too long");
+
+                // texts are never overwritten, so an equal text can share the handle
+                const auto hash = fc::sha256::hash(text);
+                auto recent = recent_handles.find(hash);
+                if (recent != recent_handles.end() && is_stored_text(recent->second, text)) {
+                    return recent->second;
+                }
+
+                const text_size_type size = text.size();
+                reserve(sizeof(size) + size);
+
+                const auto handle = get_end();
+                auto* ptr = mapped_file.data() + handle;
+                std::memcpy(ptr, &size, sizeof(size));
+                std::memcpy(ptr + sizeof(size), text.data(), size);
+                set_end(handle + sizeof(size) + size);
+                if (recent == recent_handles.end()) {
+                    remember(hash, handle);
+                } else {
+                    recent->second = handle;
+                }
+                return handle;
+            }
+
+            std::string read(uint64_t handle) const {
+                const auto end = get_end();
+                FC_ASSERT(handle >= header_size && handle + sizeof(text_size_type) <= end,
+                    "Unknown handle ${handle} of content body store", ("handle", handle));
+
+                text_size_type size;
+                const auto* ptr = mapped_file.const_data() + handle;
+                std::memcpy(&size, ptr, sizeof(size));
+                FC_ASSERT(handle + sizeof(size) + size <= end,
+                    "Text ${handle} goes beyond the end of content body store", ("handle", handle));
+
+                return std::string(ptr + sizeof(size), size);
+            }
+        };
+    } // namespace detail
+
+    content_body_store::content_body_store()
+            : my(new detail::content_body_store_impl()) {
+    }
+
+    content_body_store::~content_body_store() {
+    }
+
+    void content_body_store::open(const fc::path& file) {
+        detail::write_lock lock(my->mutex);
+        my->open(file);
+    }
+
+    void content_body_store::close() {
+        detail::write_lock lock(my->mutex);
+        my->mapped_file.close();
+    }
+
+    bool content_body_store::is_open() const {
+        detail::read_lock lock(my->mutex);
+        return my->mapped_file.is_open();
+    }
+
+    uint64_t content_body_store::append(const std::string& text) {
+        if (text.empty()) {
+            return empty_handle;
+        }
+        detail::write_lock lock(my->mutex);
+        FC_ASSERT(my->mapped_file.is_open(), "Content body store is not open");
+        return my->append(text);
+    }
+
+    std::string content_body_store::read(uint64_t handle) const {
+        if (handle == empty_handle) {
+            return std::string();
+        }
+        detail::read_lock lock(my->mutex);
+        FC_ASSERT(my->mapped_file.is_open(), "Content body store is not open");
+        return my->read(handle);
+    }
+
+    uint64_t content_body_store::size() const {
+        detail::read_lock lock(my->mutex);
+        if (!my->mapped_file.is_open()) {
+            return 0;
+        }
+        return my->get_end() - detail::header_size;
+    }
+
+    void content_body_store::export_to(const fc::path& file) const { try {
+        detail::read_lock lock(my->mutex);
+        FC_ASSERT(my->mapped_file.is_open(), "Content body store is not open");
+
+        std::ofstream out(file.string(), std::ios::out|std::ios::binary|std::ios::trunc);
+        FC_ASSERT(out.good(), "Can't create ${file}", ("file", file));
+        out.write(my->mapped_file.const_data(), my->get_end());
+        out.close();
+        FC_ASSERT(!out.fail(), "Can't write ${file}", ("file", file));
+    } FC_CAPTURE_AND_RETHROW((file)) }
+
+    void content_body_store::import_from(const fc::path& file) { try {
+        detail::write_lock lock(my->mutex);
+        FC_ASSERT(my->mapped_file.is_open(), "Content body store is not open");
+
+        my->mapped_file.close();
+        boost::filesystem::remove_all(my->path);
+        boost::filesystem::copy_file(file.string(), my->path);
+        my->open(my->path);
+    } FC_CAPTURE_AND_RETHROW((file)) }
+
+} } // graphene::chain
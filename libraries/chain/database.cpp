@@ -20,6 +20,7 @@
 #include <graphene/chain/proposal_object.hpp>
 #include <graphene/chain/committee_objects.hpp>
 #include <graphene/chain/invite_objects.hpp>
+#include <graphene/chain/state_snapshot.hpp>
 
 #include <fc/smart_ref_impl.hpp>
 
@@ -32,6 +33,7 @@
 #include <csignal>
 #include <cerrno>
 #include <cstring>
+#include <mutex>
 
 #define VIRTUAL_SCHEDULE_LAP_LENGTH  ( fc::uint128_t(uint64_t(-1)) )
 #define VIRTUAL_SCHEDULE_LAP_LENGTH2 ( fc::uint128_t::max_value() )
@@ -187,6 +189,14 @@ namespace graphene { namespace chain {
 
             database &_self;
             evaluator_registry<operation> _evaluator_registry;
+
+            /**
+             * Keys recovered from the signatures of blocks in validate_block(), before the write lock,
+             * so validate_block_header() only has to compare them with the witness signing key
+             */
+            static const size_t max_prevalidated_block_signees = 64;
+            std::mutex _prevalidated_block_signees_mutex;
+            std::deque<std::pair<block_id_type, public_key_type>> _prevalidated_block_signees;
         };
 
         database_impl::database_impl(database &self)
@@ -201,13 +211,47 @@ namespace graphene { namespace chain {
             clear_pending();
         }
 
-        void database::open(const fc::path &data_dir, const fc::path &shared_mem_dir, uint64_t initial_supply, uint64_t shared_file_size, uint32_t chainbase_flags) {
+        void database::open(const fc::path &data_dir, const fc::path &shared_mem_dir, uint64_t initial_supply, uint64_t shared_file_size, uint32_t chainbase_flags, const fc::path &snapshot_dir) {
             try {
                 auto start = fc::time_point::now();
                 wlog("Start opening database. Please wait, don't break application...");
 
                 init_schema();
+
+                _shared_mem_dir = shared_mem_dir;
+                fc::create_directories(shared_mem_dir);
+                if (chainbase_flags & chainbase::database::read_write) {
+                    // a read-only open, e.g. of dump_index_memory, doesn't use the block log and the content bodies
+                    fc::create_directories(data_dir);
+                }
+                if (!snapshot_dir.empty() && (chainbase_flags & chainbase::database::read_write)) {
+                    // objects are imported by several threads, so the file can't grow until all of them are done
+                    auto header = fc::json::from_file(snapshot_dir / "snapshot.json").as<state_snapshot_header>();
+                    uint64_t required_size = header.shared_memory_size() + _min_free_shared_memory_size;
+                    if (shared_file_size < required_size) {
+                        ilog("Increasing shared memory file to ${mem}M for the state snapshot",
+                             ("mem", required_size / (1024 * 1024)));
+                        shared_file_size = required_size;
+                    }
+                }
+                const auto huge_page_size = hugetlbfs_page_size(shared_mem_dir);
+                if (huge_page_size != 0) {
+                    // the block log and the content bodies are written by write(2), which hugetlbfs doesn't support
+                    FC_ASSERT(!(chainbase_flags & chainbase::database::read_write) || hugetlbfs_page_size(data_dir) == 0,
+                        "Data dir ${dir} can't be on hugetlbfs, only shared-file-dir can", ("dir", data_dir));
+                    check_hugetlbfs_dir(shared_mem_dir);
+                    // the file on hugetlbfs can only have a size in whole huge pages
+                    if (shared_file_size % huge_page_size != 0) {
+                        shared_file_size += huge_page_size - shared_file_size % huge_page_size;
+                    }
+                }
                 chainbase::database::open(shared_mem_dir, chainbase_flags, shared_file_size);
+                apply_shared_memory_mapping();
+
+                if (chainbase_flags & chainbase::database::read_write) {
+                    // the store is near the block log, so shared-file-dir can be on tmpfs or hugetlbfs
+                    _content_body_store.open(data_dir / "content_bodies");
+                }
 
                 initialize_indexes();
                 initialize_evaluators();
@@ -219,7 +263,16 @@ namespace graphene { namespace chain {
                     start = fc::time_point::now();
                     wlog("Start opening block log. Please wait, don't break application...");
 
-                    if (!find<dynamic_global_property_object>()) {
+                    optional<signed_block> snapshot_block;
+                    if (!snapshot_dir.empty()) {
+                        FC_ASSERT(!find<dynamic_global_property_object>(),
+                            "State snapshot can be imported only to an empty database");
+                        with_strong_write_lock([&]() {
+                            snapshot_block = import_state_snapshot(snapshot_dir);
+                            // the file was sized by an estimate, it gets the usual free space before blocks
+                            check_free_memory(true, head_block_num());
+                        });
+                    } else if (!find<dynamic_global_property_object>()) {
                         with_strong_write_lock([&]() {
                             init_genesis(initial_supply);
                         });
@@ -227,6 +280,13 @@ namespace graphene { namespace chain {
 
                     _block_log.open(data_dir / "block_log");
 
+                    if (snapshot_block.valid()) {
+                        // the block log of the imported state starts from the block of the snapshot
+                        FC_ASSERT(!_block_log.head(), "State snapshot can be imported only with an empty block log");
+                        _block_log.append(*snapshot_block);
+                        _block_log.flush();
+                    }
+
                     // Rewind all undo state. This should return us to the state at the last irreversible block.
                     with_strong_write_lock([&]() {
                         undo_all();
@@ -245,13 +305,23 @@ namespace graphene { namespace chain {
                                            ("head", head_block_num()));
                     }
 
+                    // the store isn't rolled back with the state, but it can be lost or be older than the state
+                    if (_content_body_store.size() < get_dynamic_global_properties().content_body_store_size) {
+                        FC_THROW_EXCEPTION(database_revision_exception,
+                                           "Content body store is behind the state, replay required, "
+                                           "store size is ${size}, "
+                                           "state expects ${expected}",
+                                           ("size", _content_body_store.size())
+                                           ("expected", get_dynamic_global_properties().content_body_store_size));
+                    }
+
                     if (head_block_num()) {
                         auto head_block = _block_log.read_block_by_num(head_block_num());
                         // This assertion should be caught and a reindex should occur
                         FC_ASSERT(head_block.valid() && head_block->id() ==
                                                         head_block_id(), "Chain state does not match block log. Please reindex blockchain.");
 
-                        _fork_db.start_block(*head_block);
+                        _fork_db.start_block(std::make_shared<const signed_block>(std::move(*head_block)));
                     }
                     end = fc::time_point::now();
                     wlog("Done opening block log, elapsed time ${t} sec", ("t", double((end - start).count()) / 1000000.0));
@@ -265,13 +335,16 @@ namespace graphene { namespace chain {
             FC_CAPTURE_LOG_AND_RETHROW((data_dir)(shared_mem_dir)(shared_file_size))
         }
 
-        void database::reindex(const fc::path &data_dir, const fc::path &shared_mem_dir, uint32_t from_block_num, uint64_t shared_file_size) {
+        void database::reindex(const fc::path &data_dir, const fc::path &shared_mem_dir, uint32_t from_block_num, uint64_t shared_file_size, uint32_t to_block_num) {
             try {
                 signal_guard sg;
                 _fork_db.reset();    // override effect of _fork_db.start_block() call in open()
 
                 auto start = fc::time_point::now();
                 CHAIN_ASSERT(_block_log.head(), block_log_exception, "No blocks in block log. Cannot reindex an empty chain.");
+                CHAIN_ASSERT(_block_log.first_block_num() == 1, block_log_exception,
+                    "Block log starts from block ${n} of a state snapshot. Cannot reindex it.",
+                    ("n", _block_log.first_block_num()));
 
                 ilog("Replaying blocks...");
 
@@ -290,6 +363,9 @@ namespace graphene { namespace chain {
                 with_strong_write_lock([&]() {
                     auto cur_block_num = from_block_num;
                     auto last_block_num = _block_log.head()->block_num();
+                    if (to_block_num != 0 && to_block_num < last_block_num) {
+                        last_block_num = to_block_num;
+                    }
                     auto last_block_pos = _block_log.get_block_pos(last_block_num);
                     int last_reindex_percent = 0;
 
@@ -336,8 +412,10 @@ namespace graphene { namespace chain {
                     appbase::app().quit();
                 }
 
-                if (_block_log.head()->block_num()) {
-                    _fork_db.start_block(*_block_log.head());
+                if (head_block_num()) {
+                    // the replay can stop before the head of the block log
+                    auto head_block = _block_log.read_block_by_num(head_block_num());
+                    _fork_db.start_block(std::make_shared<const signed_block>(std::move(*head_block)));
                 }
                 auto end = fc::time_point::now();
                 ilog("Done reindexing, elapsed time: ${t} sec", ("t",
@@ -359,11 +437,83 @@ namespace graphene { namespace chain {
             _block_num_check_free_memory = value;
         }
 
+        void database::set_shared_memory_forecast_blocks(uint32_t value) {
+            _shared_memory_forecast_blocks = value;
+        }
+
+        void database::set_store_content_bodies(bool value) {
+            _store_content_bodies = value;
+        }
+
+        void database::set_lean_transaction_objects(bool value) {
+            _lean_transaction_objects = value;
+        }
+
+        void database::set_shared_memory_mapping_options(const shared_memory_mapping_options &value) {
+            _shared_memory_mapping_options = value;
+        }
+
+        const shared_memory_mapping_info &database::get_shared_memory_mapping_info() const {
+            return _shared_memory_mapping_info;
+        }
+
+        void database::apply_shared_memory_mapping(uint64_t prefault_offset) {
+            _shared_memory_mapping_info = apply_shared_memory_mapping_options(
+                get_segment_manager(), max_memory(), _shared_mem_dir, _shared_memory_mapping_options, prefault_offset);
+
+            const auto &info = _shared_memory_mapping_info;
+            ilog(
+                "Shared memory file is on ${fs}, page size ${page}K, ${huge}M in huge pages, locked: ${locked}, NUMA node: ${node}",
+                ("fs", info.file_system)("page", info.page_size / 1024)("huge", info.huge_pages_size / (1024 * 1024))
+                ("locked", info.locked)("node", info.numa_node));
+        }
+
+        const content_body_store &database::get_content_body_store() const {
+            return _content_body_store;
+        }
+
+        uint64_t database::shared_memory_growth_per_block() const {
+            return uint64_t(_shared_memory_growth_per_block);
+        }
+
+        uint32_t database::shared_memory_forecast_blocks() const {
+            return _shared_memory_forecast_blocks;
+        }
+
+        uint64_t database::shared_memory_forecast() const {
+            return shared_memory_growth_per_block() * _shared_memory_forecast_blocks;
+        }
+
+        uint32_t database::shared_memory_resize_count() const {
+            return _shared_memory_resize_count;
+        }
+
+        uint32_t database::shared_memory_bad_alloc_count() const {
+            return _shared_memory_bad_alloc_count;
+        }
+
+        uint32_t database::last_shared_memory_resize_block_num() const {
+            return _last_shared_memory_resize_block_num;
+        }
+
+        void database::update_shared_memory_forecast() {
+            // the average is taken over about this number of the last blocks
+            static const uint32_t growth_window = 1000;
+
+            uint64_t used_mem = max_memory() - free_memory();
+            if (_last_used_memory != 0) {
+                // freed memory isn't counted, so the forecast errs on the side of growing
+                double growth = used_mem > _last_used_memory ? double(used_mem - _last_used_memory) : 0;
+                _shared_memory_growth_per_block += (growth - _shared_memory_growth_per_block) / growth_window;
+            }
+            _last_used_memory = used_mem;
+        }
+
         void database::set_skip_virtual_ops() {
             _skip_virtual_ops = true;
         }
 
-        bool database::_resize(uint32_t current_block_num) {
+        bool database::_resize(uint32_t current_block_num, uint64_t min_increase) {
             if (_inc_shared_memory_size == 0) {
                 elog("Auto-scaling of shared file size is not configured!. Do it immediately!");
                 return false;
@@ -371,11 +521,20 @@ namespace graphene { namespace chain {
 
             uint64_t max_mem = max_memory();
 
-            size_t new_max = max_mem + _inc_shared_memory_size;
+            // grow by whole steps of inc-shared-file-size
+            uint64_t steps = std::max<uint64_t>(1, (min_increase + _inc_shared_memory_size - 1) / _inc_shared_memory_size);
+            size_t new_max = max_mem + steps * _inc_shared_memory_size;
+            const auto huge_page_size = hugetlbfs_page_size(_shared_mem_dir);
+            if (huge_page_size != 0 && new_max % huge_page_size != 0) {
+                new_max += huge_page_size - new_max % huge_page_size;
+            }
             wlog(
                 "Memory is almost full on block ${block}, increasing to ${mem}M",
                 ("block", current_block_num)("mem", new_max / (1024 * 1024)));
             resize(new_max);
+            // the file is mapped again on resize, so madvise, mlock and mbind are set for the new mapping,
+            // but only the added range is prefaulted, pages of the old one are in memory already
+            apply_shared_memory_mapping(max_mem);
 
             uint64_t free_mem = free_memory();
             uint64_t reserved_mem = reserved_memory();
@@ -388,13 +547,20 @@ namespace graphene { namespace chain {
             uint32_t reserved_mb = uint32_t(reserved_mem / (1024 * 1024));
             wlog("Free memory is now ${free}M (${reserved}M)", ("free", free_mb)("reserved", reserved_mb));
             _last_free_gb_printed = free_mb / 1024;
+            _shared_memory_resize_count++;
+            _last_shared_memory_resize_block_num = current_block_num;
+            // the used size doesn't change on resize, so the growth is measured from the same point
+            _last_used_memory = max_memory() - free_memory();
             return true;
         }
 
+        /**
+         * Called after each applied block, it's the quiet point before the next slot: the free space should
+         * cover the forecasted allocations of the next blocks, so a block is never applied into a full file.
+         * The check itself is cheap, only printing is done every _block_num_check_free_memory blocks.
+         */
         void database::check_free_memory(bool skip_print, uint32_t current_block_num) {
-            if (0 != current_block_num % _block_num_check_free_memory) {
-                return;
-            }
+            update_shared_memory_forecast();
 
             uint64_t reserved_mem = reserved_memory();
             uint64_t free_mem = free_memory();
@@ -405,11 +571,19 @@ namespace graphene { namespace chain {
                 set_reserved_memory(0);
             }
 
-            if (_inc_shared_memory_size != 0 && _min_free_shared_memory_size != 0 &&
-                free_mem < _min_free_shared_memory_size
-            ) {
-                _resize(current_block_num);
-            } else if (!skip_print && _inc_shared_memory_size == 0 && _min_free_shared_memory_size == 0) {
+            if (_inc_shared_memory_size != 0 && _min_free_shared_memory_size != 0) {
+                uint64_t required_mem = std::max<uint64_t>(_min_free_shared_memory_size, shared_memory_forecast());
+                if (free_mem < required_mem) {
+                    _resize(current_block_num, required_mem - free_mem);
+                }
+                return;
+            }
+
+            if (0 != current_block_num % _block_num_check_free_memory) {
+                return;
+            }
+
+            if (!skip_print && _inc_shared_memory_size == 0 && _min_free_shared_memory_size == 0) {
                 uint32_t free_gb = uint32_t(free_mem / (1024 * 1024 * 1024));
                 if ((free_gb < _last_free_gb_printed) || (free_gb > _last_free_gb_printed + 1)) {
                     ilog(
@@ -427,12 +601,97 @@ namespace graphene { namespace chain {
             }
         }
 
+        std::vector<index_memory_usage> database::get_index_memory_usage(uint32_t objects_per_lock) {
+            std::vector<index_memory_usage> result;
+            result.reserve(_index_memory_accountings.size());
+
+            for (const auto &accounting: _index_memory_accountings) {
+                index_memory_usage usage;
+                with_weak_read_lock([&]() {
+                    usage = accounting->get_fixed_usage();
+                });
+
+                for (int64_t next_id = 0; next_id != -1;) {
+                    with_weak_read_lock([&]() {
+                        next_id = accounting->add_dynamic_usage(next_id, objects_per_lock, usage.dynamic_size);
+                    });
+                }
+
+                usage.total_size = usage.fixed_size + usage.node_overhead + usage.dynamic_size;
+                result.push_back(std::move(usage));
+            }
+            return result;
+        }
+
+        void database::set_undo_usage_history(uint32_t value) {
+            _undo_usage_history = value;
+        }
+
+        void database::set_undo_warning_blocks(uint32_t value) {
+            _undo_warning_blocks = value;
+        }
+
+        std::vector<undo_state_usage> database::get_undo_state_usage(uint32_t limit) const {
+            std::vector<undo_state_usage> result;
+            for (auto itr = _undo_state_usage.rbegin(); itr != _undo_state_usage.rend() && result.size() < limit; ++itr) {
+                result.push_back(*itr);
+            }
+            return result;
+        }
+
+        void database::update_undo_state_usage(uint32_t block_num) {
+            undo_state_usage usage;
+            usage.block_num = block_num;
+            usage.last_irreversible_block_num = get_dynamic_global_properties().last_irreversible_block_num;
+
+            for (const auto &accounting: _index_memory_accountings) {
+                usage.undo_depth = std::max(usage.undo_depth, accounting->get_undo_depth());
+            }
+            if (usage.undo_depth == 0) {
+                // blocks are applied without undo on replay
+                return;
+            }
+
+            for (const auto &accounting: _index_memory_accountings) {
+                auto index = accounting->get_undo_usage();
+                if (index.retained_objects == 0) {
+                    continue;
+                }
+                usage.created += index.created;
+                usage.modified += index.modified;
+                usage.removed += index.removed;
+                usage.size += index.size;
+                usage.retained_size += index.retained_size;
+                usage.indexes.push_back(std::move(index));
+            }
+
+            const uint32_t reversible_blocks = block_num - usage.last_irreversible_block_num;
+            if (_undo_warning_blocks == 0 || reversible_blocks < _undo_warning_blocks) {
+                _last_undo_warning_size = 0;
+            } else if (usage.retained_size > _last_undo_warning_size && reversible_blocks % 20 == 0) {
+                // repeat once per minute while undo states grow
+                wlog("Last irreversible block ${lib} is ${n} blocks behind head ${head}, "
+                     "undo states of ${depth} blocks take ${size}M",
+                     ("lib", usage.last_irreversible_block_num)("n", reversible_blocks)("head", block_num)
+                     ("depth", usage.undo_depth)("size", usage.retained_size / (1024 * 1024)));
+                _last_undo_warning_size = usage.retained_size;
+            }
+
+            _undo_state_usage.push_back(std::move(usage));
+            while (_undo_state_usage.size() > _undo_usage_history) {
+                _undo_state_usage.pop_front();
+            }
+        }
+
         void database::wipe(const fc::path &data_dir, const fc::path &shared_mem_dir, bool include_blocks) {
             close();
             chainbase::database::wipe(shared_mem_dir);
+            // handles of texts are a part of the state, so the store is wiped together with it
+            fc::remove_all(data_dir / "content_bodies");
             if (include_blocks) {
                 fc::remove_all(data_dir / "block_log");
                 fc::remove_all(data_dir / "block_log.index");
+                fc::remove_all(data_dir / "block_log.ids");
             }
         }
 
@@ -447,6 +706,7 @@ namespace graphene { namespace chain {
                 chainbase::database::close();
 
                 _block_log.close();
+                _content_body_store.close();
 
                 _fork_db.reset();
             }
@@ -455,7 +715,11 @@ namespace graphene { namespace chain {
 
         bool database::is_known_block(const block_id_type &id) const {
             try {
-                return fetch_block_by_id(id).valid();
+                if (_fork_db.is_known_block(id)) {
+                    return true;
+                }
+                return id != block_id_type() &&
+                       _block_log.read_block_id_by_num(protocol::block_header::num_from_id(id)) == id;
             } FC_CAPTURE_AND_RETHROW()
         }
 
@@ -490,9 +754,9 @@ namespace graphene { namespace chain {
 
                 // Next we query the block log. Irreversible blocks are here.
 
-                auto b = _block_log.read_block_by_num(block_num);
-                if (b.valid()) {
-                    return b->id();
+                block_id_type id = _block_log.read_block_id_by_num(block_num);
+                if (id != block_id_type()) {
+                    return id;
                 }
 
                 // Finally we query the fork DB.
@@ -516,17 +780,17 @@ namespace graphene { namespace chain {
             try {
                 auto b = _fork_db.fetch_block(id);
                 if (!b) {
-                    auto tmp = _block_log.read_block_by_num(protocol::block_header::num_from_id(id));
+                    optional<signed_block> tmp;
+                    uint32_t block_num = protocol::block_header::num_from_id(id);
 
-                    if (tmp && tmp->id() == id) {
-                        return tmp;
+                    // don't unpack a block of another fork just to find out its id differs
+                    if (id != block_id_type() && _block_log.read_block_id_by_num(block_num) == id) {
+                        tmp = _block_log.read_block_by_num(block_num);
                     }
-
-                    tmp.reset();
                     return tmp;
                 }
 
-                return b->data;
+                return *b->data;
             } FC_CAPTURE_AND_RETHROW()
         }
 
@@ -536,7 +800,7 @@ namespace graphene { namespace chain {
 
                 auto results = _fork_db.fetch_block_by_number(block_num);
                 if (results.size() == 1) {
-                    b = results[0]->data;
+                    b = *results[0]->data;
                 } else {
                     b = _block_log.read_block_by_num(block_num);
                 }
@@ -545,15 +809,78 @@ namespace graphene { namespace chain {
             } FC_LOG_AND_RETHROW()
         }
 
+        std::shared_ptr<const signed_block> database::fetch_shared_block_by_id(const block_id_type &id) const {
+            try {
+                auto b = _fork_db.fetch_block(id);
+                if (b) {
+                    return b->data;
+                }
+
+                uint32_t block_num = protocol::block_header::num_from_id(id);
+                if (id != block_id_type() && _block_log.read_block_id_by_num(block_num) == id) {
+                    auto block = _block_log.read_block_by_num(block_num);
+                    if (block.valid()) {
+                        return std::make_shared<const signed_block>(std::move(*block));
+                    }
+                }
+                return std::shared_ptr<const signed_block>();
+            } FC_CAPTURE_AND_RETHROW()
+        }
+
+        std::shared_ptr<const signed_block> database::fetch_shared_block_by_number(uint32_t block_num) const {
+            try {
+                auto b = _fork_db.fetch_block_on_main_branch_by_number(block_num);
+                if (b) {
+                    return b->data;
+                }
+
+                auto block = _block_log.read_block_by_num(block_num);
+                if (block.valid()) {
+                    return std::make_shared<const signed_block>(std::move(*block));
+                }
+                return std::shared_ptr<const signed_block>();
+            } FC_LOG_AND_RETHROW()
+        }
+
+        std::vector<char> database::fetch_serialized_reversible_block(const block_id_type &id) const {
+            auto b = _fork_db.fetch_block(id);
+            if (b) {
+                return b->packed;
+            }
+            return std::vector<char>();
+        }
+
         const signed_transaction database::get_recent_transaction(const transaction_id_type &trx_id) const {
             try {
                 auto &index = get_index<transaction_index>().indices().get<by_trx_id>();
                 auto itr = index.find(trx_id);
                 FC_ASSERT(itr != index.end());
-                signed_transaction trx;
-                fc::raw::unpack(itr->packed_trx, trx);
-                return trx;;
-            } FC_CAPTURE_AND_RETHROW()
+                if (!itr->packed_trx.empty()) {
+                    signed_transaction trx;
+                    fc::raw::unpack(itr->packed_trx, trx);
+                    return trx;
+                }
+
+                // lean transaction object: the transaction is either pending or is in the block it refers to,
+                // peers can ask for any id, so only that one block is read
+                for (const auto &trx: _pending_tx) {
+                    if (trx.id() == trx_id) {
+                        return trx;
+                    }
+                }
+
+                auto block = fetch_shared_block_by_number(itr->block_num);
+                if (block) {
+                    for (const auto &trx: block->transactions) {
+                        if (trx.id() == trx_id) {
+                            return trx;
+                        }
+                    }
+                }
+                FC_THROW_EXCEPTION(fc::key_not_found_exception,
+                    "Transaction ${id} isn't found in pending transactions and block ${n}",
+                    ("id", trx_id)("n", itr->block_num));
+            } FC_CAPTURE_AND_RETHROW((trx_id))
         }
 
         std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of_fork) const {
@@ -632,6 +959,45 @@ namespace graphene { namespace chain {
             return find<content_type_object, by_content>(content);
         }
 
+        std::string database::get_content_title(const content_type_object &content) const {
+            try {
+                if (content.title_blob != content_body_store::empty_handle) {
+                    return _content_body_store.read(content.title_blob);
+                }
+                return to_string(content.title);
+            } FC_CAPTURE_AND_RETHROW((content.content))
+        }
+
+        std::string database::get_content_body(const content_type_object &content) const {
+            try {
+                if (content.body_blob != content_body_store::empty_handle) {
+                    return _content_body_store.read(content.body_blob);
+                }
+                return to_string(content.body);
+            } FC_CAPTURE_AND_RETHROW((content.content))
+        }
+
+        std::string database::get_content_json_metadata(const content_type_object &content) const {
+            try {
+                if (content.json_metadata_blob != content_body_store::empty_handle) {
+                    return _content_body_store.read(content.json_metadata_blob);
+                }
+                return to_string(content.json_metadata);
+            } FC_CAPTURE_AND_RETHROW((content.content))
+        }
+
+        void database::set_content_text(shared_string &value, uint64_t &blob, const std::string &text) {
+            if (_store_content_bodies) {
+                // the old text stays in the store, undo of the object returns its old handle
+                blob = _content_body_store.append(text);
+                value.clear();
+                value.shrink_to_fit();
+            } else {
+                from_string(value, text);
+                blob = content_body_store::empty_handle;
+            }
+        }
+
         const escrow_object &database::get_escrow(const account_name_type &name, uint32_t escrow_id) const {
             try {
                 return get<escrow_object, by_from_id>(boost::make_tuple(name, escrow_id));
@@ -738,9 +1104,28 @@ namespace graphene { namespace chain {
                 skip_merkle_check |
                 skip_block_size_check;
 
+            // the expensive parts don't depend on the state, do them before taking the lock
+            if (!(skip & skip_witness_signature)) {
+                prevalidate_block_signee(new_block);
+            }
+
             if ((skip & validate_block_steps) != validate_block_steps) {
+                checksum_type merkle_root;
+                if (!(skip & skip_merkle_check)) {
+                    merkle_root = new_block.calculate_merkle_root();
+                }
+                size_t block_size = 0;
+                if (!(skip & skip_block_size_check)) {
+                    block_size = fc::raw::pack_size(new_block);
+                }
+
                 with_strong_read_lock([&](){
-                    _validate_block(new_block, skip);
+                    if (!(skip & skip_merkle_check)) {
+                        check_block_merkle_root(new_block, merkle_root);
+                    }
+                    if (!(skip & skip_block_size_check)) {
+                        check_block_size(new_block, block_size);
+                    }
                 });
 
                 skip |= validate_block_steps;
@@ -754,41 +1139,72 @@ namespace graphene { namespace chain {
         }
 
         void database::_validate_block(const signed_block& new_block, uint32_t skip) {
-            uint32_t new_block_num = new_block.block_num();
-
             if (!(skip & skip_merkle_check)) {
-                auto merkle_root = new_block.calculate_merkle_root();
-
-                try {
-                    FC_ASSERT(
-                        new_block.transaction_merkle_root == merkle_root,
-                        "Merkle check failed",
-                        ("next_block.transaction_merkle_root", new_block.transaction_merkle_root)
-                        ("calc", merkle_root)
-                        ("next_block", new_block)
-                        ("id", new_block.id()));
-                } catch (fc::assert_exception &e) {
-                    const auto &merkle_map = get_shared_db_merkle();
-                    auto itr = merkle_map.find(new_block_num);
-
-                    if (itr == merkle_map.end() || itr->second != merkle_root) {
-                        throw e;
-                    }
-                }
+                check_block_merkle_root(new_block, new_block.calculate_merkle_root());
             }
 
             if (!(skip & skip_block_size_check)) {
-                const auto &gprops = get_dynamic_global_properties();
-                auto block_size = fc::raw::pack_size(new_block);
+                check_block_size(new_block, fc::raw::pack_size(new_block));
+            }
+        }
+
+        void database::check_block_merkle_root(const signed_block& new_block, const checksum_type& merkle_root) const {
+            try {
                 FC_ASSERT(
-                    block_size <= gprops.maximum_block_size,
-                    "Block Size is too Big",
-                    ("next_block_num", new_block_num)
-                    ("block_size", block_size)
-                    ("max", gprops.maximum_block_size));
+                    new_block.transaction_merkle_root == merkle_root,
+                    "Merkle check failed",
+                    ("next_block.transaction_merkle_root", new_block.transaction_merkle_root)
+                    ("calc", merkle_root)
+                    ("next_block", new_block)
+                    ("id", new_block.id()));
+            } catch (fc::assert_exception &e) {
+                const auto &merkle_map = get_shared_db_merkle();
+                auto itr = merkle_map.find(new_block.block_num());
+
+                if (itr == merkle_map.end() || itr->second != merkle_root) {
+                    throw e;
+                }
+            }
+        }
+
+        void database::check_block_size(const signed_block& new_block, size_t block_size) const {
+            const auto &gprops = get_dynamic_global_properties();
+            FC_ASSERT(
+                block_size <= gprops.maximum_block_size,
+                "Block Size is too Big",
+                ("next_block_num", new_block.block_num())
+                ("block_size", block_size)
+                ("max", gprops.maximum_block_size));
+        }
+
+        void database::prevalidate_block_signee(const signed_block& new_block) {
+            auto signee = new_block.signee();
+            auto block_id = new_block.id();
+
+            std::lock_guard<std::mutex> lock(_my->_prevalidated_block_signees_mutex);
+            auto &signees = _my->_prevalidated_block_signees;
+            signees.emplace_back(block_id, signee);
+            if (signees.size() > database_impl::max_prevalidated_block_signees) {
+                signees.pop_front();
             }
         }
 
+        public_key_type database::get_block_signee(const signed_block& next_block) const {
+            {
+                auto block_id = next_block.id();
+
+                std::lock_guard<std::mutex> lock(_my->_prevalidated_block_signees_mutex);
+                const auto &signees = _my->_prevalidated_block_signees;
+                // the id covers the signature, so the same id means the same signee
+                for (auto itr = signees.rbegin(); itr != signees.rend(); ++itr) {
+                    if (itr->first == block_id) {
+                        return itr->second;
+                    }
+                }
+            }
+            return next_block.signee();
+        }
+
        /**
         * Push block "may fail" in which case every partial change is unwound. After
         * push block is successful the block is appended to the chain database on disk.
@@ -796,13 +1212,18 @@ namespace graphene { namespace chain {
         * @return true if we switched forks as a result of this push.
         */
         bool database::push_block(const signed_block &new_block, uint32_t skip) {
+            return push_block(std::make_shared<const signed_block>(new_block), skip);
+        }
+
+        bool database::push_block(const std::shared_ptr<const signed_block> &new_block_ptr, uint32_t skip) {
             //fc::time_point begin_time = fc::time_point::now();
+            const auto &new_block = *new_block_ptr;
 
             bool result;
             with_strong_write_lock([&]() {
                 detail::without_pending_transactions(*this, skip, std::move(_pending_tx), [&]() {
                     try {
-                        result = _push_block(new_block, skip);
+                        result = _push_block(new_block_ptr, skip);
                         check_free_memory(false, new_block.block_num());
                     } catch (const fc::exception &e) {
                         auto msg = std::string(e.what());
@@ -811,11 +1232,12 @@ namespace graphene { namespace chain {
                             throw e;
                         }
                         wlog("Receive bad_alloc exception. Forcing to resize shared memory file.");
+                        _shared_memory_bad_alloc_count++;
                         set_reserved_memory(free_memory());
                         if (!_resize(new_block.block_num())) {
                             throw e;
                         }
-                        result = _push_block(new_block, skip);
+                        result = _push_block(new_block_ptr, skip);
                     }
                 });
             });
@@ -832,7 +1254,7 @@ namespace graphene { namespace chain {
             if (blocks.size() > 1) {
                 vector<std::pair<account_name_type, fc::time_point_sec>> witness_time_pairs;
                 for (const auto &b : blocks) {
-                    witness_time_pairs.push_back(std::make_pair(b->data.witness, b->data.timestamp));
+                    witness_time_pairs.push_back(std::make_pair(b->data->witness, b->data->timestamp));
                 }
 
                 ilog(
@@ -842,33 +1264,34 @@ namespace graphene { namespace chain {
             return;
         }
 
-        bool database::_push_block(const signed_block &new_block, uint32_t skip) {
+        bool database::_push_block(const std::shared_ptr<const signed_block> &new_block_ptr, uint32_t skip) {
             try {
+                const auto &new_block = *new_block_ptr;
                 if (!(skip & skip_fork_db)) {
-                    shared_ptr<fork_item> new_head = _fork_db.push_block(new_block);
+                    shared_ptr<fork_item> new_head = _fork_db.push_block(new_block_ptr);
                     _maybe_warn_multiple_production(new_head->num);
                     //If the head block from the longest chain does not build off of the current head, we need to switch forks.
-                    if (new_head->data.previous != head_block_id()) {
+                    if (new_head->data->previous != head_block_id()) {
                         //If the newly pushed block is the same height as head, we get head back in new_head
                         //Only switch forks if new_head is actually higher than head
-                        if (new_head->data.block_num() > head_block_num()) {
-                            // wlog( "Switching to fork: ${id}", ("id",new_head->data.id()) );
-                            auto branches = _fork_db.fetch_branch_from(new_head->data.id(), head_block_id());
+                        if (new_head->num > head_block_num()) {
+                            // wlog( "Switching to fork: ${id}", ("id",new_head->id) );
+                            auto branches = _fork_db.fetch_branch_from(new_head->id, head_block_id());
 
                             // pop blocks until we hit the forked block
                             while (head_block_id() !=
-                                   branches.second.back()->data.previous) {
+                                   branches.second.back()->data->previous) {
                                 pop_block();
                             }
 
                             // push all blocks on the new fork
                             for (auto ritr = branches.first.rbegin();
                                  ritr != branches.first.rend(); ++ritr) {
-                                // ilog( "pushing blocks from fork ${n} ${id}", ("n",(*ritr)->data.block_num())("id",(*ritr)->data.id()) );
+                                // ilog( "pushing blocks from fork ${n} ${id}", ("n",(*ritr)->num)("id",(*ritr)->id) );
                                 optional<fc::exception> except;
                                 try {
                                     auto session = start_undo_session();
-                                    apply_block((*ritr)->data, skip);
+                                    apply_block(*(*ritr)->data, skip);
                                     session.push();
                                 }
                                 catch (const fc::exception &e) {
@@ -878,14 +1301,14 @@ namespace graphene { namespace chain {
                                     // wlog( "exception thrown while switching forks ${e}", ("e",except->to_detail_string() ) );
                                     // remove the rest of branches.first from the fork_db, those blocks are invalid
                                     while (ritr != branches.first.rend()) {
-                                        _fork_db.remove((*ritr)->data.id());
+                                        _fork_db.remove((*ritr)->id);
                                         ++ritr;
                                     }
                                     _fork_db.set_head(branches.second.front());
 
                                     // pop all blocks from the bad fork
                                     while (head_block_id() !=
-                                           branches.second.back()->data.previous) {
+                                           branches.second.back()->data->previous) {
                                         pop_block();
                                     }
 
@@ -894,7 +1317,7 @@ namespace graphene { namespace chain {
                                          ritr !=
                                          branches.second.rend(); ++ritr) {
                                         auto session = start_undo_session();
-                                        apply_block((*ritr)->data, skip);
+                                        apply_block(*(*ritr)->data, skip);
                                         session.push();
                                     }
                                     throw *except;
@@ -2359,6 +2782,9 @@ namespace graphene { namespace chain {
         }
 
         void database::initialize_indexes() {
+            _state_snapshot_indexes.clear();
+            _index_memory_accountings.clear();
+
             add_core_index<dynamic_global_property_index>(*this);
             add_core_index<account_index>(*this);
             add_core_index<account_authority_index>(*this);
@@ -2981,6 +3407,9 @@ namespace graphene { namespace chain {
                 notify_applied_block(next_block);
 
                 notify_changed_objects();
+
+                // after plugins, as their objects are in the same undo state
+                update_undo_state_usage(next_block.block_num());
             } FC_CAPTURE_LOG_AND_RETHROW((next_block.block_num()))
         }
 
@@ -3065,7 +3494,11 @@ namespace graphene { namespace chain {
                     create<transaction_object>([&](transaction_object &transaction) {
                         transaction.trx_id = trx_id;
                         transaction.expiration = trx.expiration;
-                        fc::raw::pack(transaction.packed_trx, trx);
+                        // the head block is updated after transactions of the next block are applied
+                        transaction.block_num = head_block_num() + 1;
+                        if (!_lean_transaction_objects) {
+                            fc::raw::pack(transaction.packed_trx, trx);
+                        }
                     });
                 }
 
@@ -3102,7 +3535,7 @@ namespace graphene { namespace chain {
                 const witness_object &witness = get_witness(next_block.witness);
 
                 if (!(skip & skip_witness_signature))
-                    FC_ASSERT(next_block.validate_signee(witness.signing_key));
+                    FC_ASSERT(get_block_signee(next_block) == witness.signing_key);
 
                 if (!(skip & skip_witness_schedule_check)) {
                     uint32_t slot_num = get_slot_at_time(next_block.timestamp);
@@ -3169,6 +3602,8 @@ namespace graphene { namespace chain {
                     dgp.head_block_id = b.id();
                     dgp.time = b.timestamp;
                     dgp.current_aslot += missed_blocks + 1;
+                    // texts of the block are in the store already, its end is kept with the state
+                    dgp.content_body_store_size = _content_body_store.size();
                     dgp.average_block_size =
                             (99 * dgp.average_block_size + block_size) / 100;
 
@@ -3287,7 +3722,7 @@ namespace graphene { namespace chain {
                             std::shared_ptr<fork_item> block = _fork_db.fetch_block_on_main_branch_by_number(
                                     log_head_num + 1);
                             FC_ASSERT(block, "Current fork in the fork database does not contain the last_irreversible_block");
-                            _block_log.append(block->data);
+                            _block_log.append(*block->data, block->packed);
                             log_head_num++;
                         }
 
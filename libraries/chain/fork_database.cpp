@@ -20,7 +20,7 @@ namespace graphene {
             _head = prev;
         }
 
-        void fork_database::start_block(signed_block b) {
+        void fork_database::start_block(std::shared_ptr<const signed_block> b) {
             auto item = std::make_shared<fork_item>(std::move(b));
             _index.insert(item);
             _head = item;
@@ -30,14 +30,14 @@ namespace graphene {
  * Pushes the block into the fork database and caches it if it doesn't link
  *
  */
-        shared_ptr<fork_item> fork_database::push_block(const signed_block &b) {
+        shared_ptr<fork_item> fork_database::push_block(const std::shared_ptr<const signed_block> &b) {
             auto item = std::make_shared<fork_item>(b);
             try {
                 _push_block(item);
             }
             catch (const unlinkable_block_exception &e) {
-                wlog("Pushing block to fork database that failed to link: ${id}, ${num}", ("id", b.id())("num", b.block_num()));
-                wlog("Head: ${num}, ${id}", ("num", _head->data.block_num())("id", _head->data.id()));
+                wlog("Pushing block to fork database that failed to link: ${id}, ${num}", ("id", item->id)("num", item->num));
+                wlog("Head: ${num}, ${id}", ("num", _head->num)("id", _head->id));
                 throw;
                 _unlinked_index.insert(item);
             }
@@ -180,20 +180,20 @@ namespace graphene {
                 auto second_branch = *second_branch_itr;
 
 
-                while (first_branch->data.block_num() >
-                       second_branch->data.block_num()) {
+                while (first_branch->num >
+                       second_branch->num) {
                     result.first.push_back(first_branch);
                     first_branch = first_branch->prev.lock();
                     FC_ASSERT(first_branch);
                 }
-                while (second_branch->data.block_num() >
-                       first_branch->data.block_num()) {
+                while (second_branch->num >
+                       first_branch->num) {
                     result.second.push_back(second_branch);
                     second_branch = second_branch->prev.lock();
                     FC_ASSERT(second_branch);
                 }
-                while (first_branch->data.previous !=
-                       second_branch->data.previous) {
+                while (first_branch->data->previous !=
+                       second_branch->data->previous) {
                     result.first.push_back(first_branch);
                     result.second.push_back(second_branch);
                     first_branch = first_branch->prev.lock();
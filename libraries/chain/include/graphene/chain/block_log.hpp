@@ -33,6 +33,18 @@ namespace graphene {
          *
          * The main file is the only file that needs to persist. The index file can be reconstructed during a
          * linear scan of the main file.
+         *
+         * A third file keeps the ids of the blocks, so they can be looked up by block number without unpacking
+         * and hashing the blocks. The id of block_num is at sizeof(block_id_type) * (block_num - 1). It is
+         * rebuilt from the block headers whenever it doesn't match the main file.
+         *
+         * +---------------+---------------+-----+------------------+
+         * | Id of Block 1 | Id of Block 2 | ... | Id of Head Block |
+         * +---------------+---------------+-----+------------------+
+         *
+         * A log started from a state snapshot begins with the block of the snapshot instead of block 1,
+         * the number of its first block is read from the first block header and positions in both
+         * index files are counted from it.
          */
 
         class block_log {
@@ -49,17 +61,47 @@ namespace graphene {
 
             uint64_t append(const signed_block& b);
 
+            /// the same as above for a block which is already packed, e.g. by the fork database
+            uint64_t append(const signed_block& b, const std::vector<char>& packed);
+
             void flush();
 
             std::pair<signed_block, uint64_t> read_block(uint64_t file_pos) const;
 
             optional <signed_block> read_block_by_num(uint32_t block_num) const;
 
+            /**
+             * Return the packed block as it is stored in the file, or an empty vector if it does not exist.
+             */
+            std::vector<char> read_serialized_block_by_num(uint32_t block_num) const;
+
+            /**
+             * Return the header of the block without reading its transactions.
+             */
+            optional<signed_block_header> read_block_header_by_num(uint32_t block_num) const;
+
+            /**
+             * Return up to count packed blocks starting from first_block_num, stops before the block
+             * which would make the total size exceed max_total_size.
+             */
+            std::vector<std::vector<char>> read_serialized_blocks(
+                uint32_t first_block_num, uint32_t count, uint64_t max_total_size) const;
+
+            /**
+             * Return id of the block without reading it, or an empty id if it does not exist.
+             */
+            block_id_type read_block_id_by_num(uint32_t block_num) const;
+
             /**
              * Return offset of block in file, or block_log::npos if it does not exist.
              */
             uint64_t get_block_pos(uint32_t block_num) const;
 
+            /**
+             * Return number of the first block in the log, it is 1 unless the log was started from a state snapshot.
+             */
+            uint32_t first_block_num() const;
+
             signed_block read_head() const;
 
             const optional <signed_block>& head() const;
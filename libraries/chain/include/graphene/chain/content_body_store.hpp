@@ -0,0 +1,66 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+
+#include <memory>
+#include <string>
+
+namespace graphene {
+    namespace chain {
+
+        namespace detail { class content_body_store_impl; }
+
+        /* The content body store is an append only file of texts of contents (title, body and json_metadata),
+         * which are written by the content evaluator and never read by consensus. The content_type_object
+         * keeps only handles of its texts, a handle is the position of the text in the file.
+         *
+         * +------------------+----------------+--------+----------------+--------+-----+
+         * | End of last text | Size of Text 1 | Text 1 | Size of Text 2 | Text 2 | ... |
+         * +------------------+----------------+--------+----------------+--------+-----+
+         *
+         * Texts are never overwritten, so undo of a block only returns old handles to the content_type_object.
+         * Texts of edited, deleted or undone contents stay in the file until the next replay, which starts
+         * the store from scratch. The file grows by chunks, so it can be larger than the end of the last text.
+         * A text equal to one of the recently appended texts isn't written again, it gets the same handle,
+         * so evaluation of one operation on push, reapply and application of its block stores it once.
+         */
+        class content_body_store {
+        public:
+            content_body_store();
+
+            ~content_body_store();
+
+            void open(const fc::path &file);
+
+            void close();
+
+            bool is_open() const;
+
+            /**
+             * Append the text and return its handle, an empty text isn't written and has the empty handle.
+             * A recently appended equal text returns its handle instead.
+             */
+            uint64_t append(const std::string &text);
+
+            std::string read(uint64_t handle) const;
+
+            /**
+             * Return the number of bytes used by texts.
+             */
+            uint64_t size() const;
+
+            /**
+             * Copy used part of the store to file, or replace the store with the file.
+             */
+            void export_to(const fc::path &file) const;
+
+            void import_from(const fc::path &file);
+
+            static const uint64_t empty_handle = 0;
+
+        private:
+            std::unique_ptr<detail::content_body_store_impl> my;
+        };
+
+    }
+} // graphene::chain
@@ -7,6 +7,9 @@
 #include <graphene/chain/witness_objects.hpp>
 
 #include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+
+#include <fc/crypto/city.hpp>
 
 
 namespace graphene {
@@ -33,6 +36,51 @@ namespace graphene {
             }
         };
 
+        /**
+         * Hashes shared and regular strings to the same value, so the hashed permlink index
+         * can be searched by std::string without copying it into shared memory.
+         * Buckets are stored in the shared memory file, so the hash must not depend on the standard
+         * or boost library version: city hash of the bytes is used for permlinks and account names.
+         */
+        struct permlink_hash {
+            std::size_t operator()(const shared_string &s) const {
+                return fc::city_hash64(s.c_str(), s.size());
+            }
+
+            std::size_t operator()(const string &s) const {
+                return fc::city_hash64(s.c_str(), s.size());
+            }
+        };
+
+        struct permlink_equal_to {
+            bool operator()(const shared_string &a, const shared_string &b) const {
+                return equal(a.c_str(), a.size(), b.c_str(), b.size());
+            }
+
+            bool operator()(const shared_string &a, const string &b) const {
+                return equal(a.c_str(), a.size(), b.c_str(), b.size());
+            }
+
+            bool operator()(const string &a, const shared_string &b) const {
+                return equal(a.c_str(), a.size(), b.c_str(), b.size());
+            }
+
+        private:
+            inline bool equal(const char *a, std::size_t a_size, const char *b, std::size_t b_size) const {
+                return a_size == b_size && std::memcmp(a, b, a_size) == 0;
+            }
+        };
+
+        struct account_name_hash {
+            std::size_t operator()(const account_name_type &a) const {
+                return (*this)(string(a));
+            }
+
+            std::size_t operator()(const string &a) const {
+                return fc::city_hash64(a.c_str(), a.size());
+            }
+        };
+
         class content_type_object
                 : public object<content_type_object_type, content_type_object> {
         public:
@@ -51,6 +99,11 @@ namespace graphene {
             shared_string title;
             shared_string body;
             shared_string json_metadata;
+
+            /// handles of texts in the content body store, they replace the strings above when it's enabled
+            uint64_t title_blob = 0;
+            uint64_t body_blob = 0;
+            uint64_t json_metadata_blob = 0;
         };
 
         class content_object
@@ -109,6 +162,7 @@ namespace graphene {
             int32_t net_votes = 0;
 
             id_type root_content;
+            id_type parent_content; ///< the content itself for root posts
 
             bip::vector <protocol::beneficiary_route_type, allocator<protocol::beneficiary_route_type>> beneficiaries;
         };
@@ -206,12 +260,15 @@ namespace graphene {
                         composite_key<content_object,
                         member <content_object, time_point_sec, &content_object::cashout_time>,
                         member<content_object, content_id_type, &content_object::id>>>,
-                ordered_unique <
-                    tag<by_permlink>, /// used by consensus to find posts referenced in ops
+                /// used by consensus to find posts referenced in ops, only exact lookups are done,
+                /// so it is hashed to avoid string comparisons along a tree path in shared memory
+                hashed_unique <
+                    tag<by_permlink>,
                         composite_key<content_object,
                         member <content_object, account_name_type, &content_object::author>,
                         member<content_object, shared_string, &content_object::permlink>>,
-                    composite_key_compare <std::less<account_name_type>, strcmp_less>>,
+                    composite_key_hash <account_name_hash, permlink_hash>,
+                    composite_key_equal_to <std::equal_to<account_name_type>, permlink_equal_to>>,
                 ordered_unique <
                     tag<by_root>,
                         composite_key<content_object,
@@ -261,9 +318,18 @@ namespace graphene {
     }
 } // graphene::chain
 
+FC_REFLECT((graphene::chain::content_object),
+        (id)(parent_author)(parent_permlink)(author)(permlink)(last_update)(created)(active)(last_payout)
+        (depth)(children)(children_rshares)(net_rshares)(abs_rshares)(vote_rshares)(cashout_time)(total_vote_weight)
+        (curation_percent)(consensus_curation_percent)(payout_value)(shares_payout_value)(curator_payout_value)
+        (beneficiary_payout_value)(author_rewards)(net_votes)(root_content)(parent_content)(beneficiaries))
 CHAINBASE_SET_INDEX_TYPE(graphene::chain::content_object, graphene::chain::content_index)
 
+FC_REFLECT((graphene::chain::content_type_object),
+        (id)(content)(title)(body)(json_metadata)(title_blob)(body_blob)(json_metadata_blob))
 CHAINBASE_SET_INDEX_TYPE(graphene::chain::content_type_object, graphene::chain::content_type_index)
 
+FC_REFLECT((graphene::chain::content_vote_object),
+        (id)(voter)(content)(weight)(rshares)(vote_percent)(last_update)(num_changes))
 CHAINBASE_SET_INDEX_TYPE(graphene::chain::content_vote_object, graphene::chain::content_vote_index)
 
@@ -4,13 +4,17 @@
 #include <graphene/chain/node_property_object.hpp>
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_log.hpp>
+#include <graphene/chain/content_body_store.hpp>
 #include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/index_memory_usage.hpp>
+#include <graphene/chain/shared_memory_mapping.hpp>
 #include <graphene/protocol/protocol.hpp>
 
 #include <fc/signals.hpp>
 
 #include <fc/log/logger.hpp>
 
+#include <deque>
 #include <map>
 
 namespace graphene { namespace chain {
@@ -28,6 +32,8 @@ namespace graphene { namespace chain {
 
         struct operation_notification;
 
+        class state_snapshot_index;
+
         /**
          *   @class database
          *   @brief tracks the blockchain state in an extensible manner
@@ -78,23 +84,62 @@ namespace graphene { namespace chain {
              * will be initialized with the default state.
              *
              * @param data_dir Path to open or create database in
+             * @param snapshot_dir If not empty, the state is imported from the state snapshot in this directory,
+             * the database and the block log should be empty
              */
-            void open(const fc::path &data_dir, const fc::path &shared_mem_dir, uint64_t initial_supply = CHAIN_INIT_SUPPLY, uint64_t shared_file_size = 0, uint32_t chainbase_flags = 0);
+            void open(const fc::path &data_dir, const fc::path &shared_mem_dir, uint64_t initial_supply = CHAIN_INIT_SUPPLY, uint64_t shared_file_size = 0, uint32_t chainbase_flags = 0, const fc::path &snapshot_dir = fc::path());
 
             /**
              * @brief Rebuild object graph from block history and open detabase
              *
              * This method may be called after or instead of @ref database::open, and will rebuild the object graph by
              * replaying blockchain history. When this method exits successfully, the database will be open.
+             * @param to_block_num If not 0, the replay stops after this block instead of the head of the block log
              */
             void reindex(const fc::path &data_dir, const fc::path &shared_mem_dir, uint32_t from_block_num, uint64_t shared_file_size = (
-                    1024l * 1024l * 1024l * 8l));
+                    1024l * 1024l * 1024l * 8l), uint32_t to_block_num = 0);
 
             void set_min_free_shared_memory_size(size_t);
             void set_inc_shared_memory_size(size_t);
             void set_block_num_check_free_size(uint32_t);
+            void set_shared_memory_forecast_blocks(uint32_t);
+            /// keep new texts of contents in the content body store instead of the shared memory file
+            void set_store_content_bodies(bool);
+            const content_body_store &get_content_body_store() const;
+            /// don't keep packed transactions in transaction_object, get_recent_transaction() reads them from blocks
+            void set_lean_transaction_objects(bool);
+            /// huge pages, prefault, lock and NUMA node of the shared memory file, applied on open and after each resize
+            void set_shared_memory_mapping_options(const shared_memory_mapping_options &);
+            const shared_memory_mapping_info &get_shared_memory_mapping_info() const;
             void check_free_memory(bool skip_print, uint32_t current_block_num);
 
+            /// average allocation of the last blocks in the shared memory file, in bytes
+            uint64_t shared_memory_growth_per_block() const;
+            uint32_t shared_memory_forecast_blocks() const;
+            /// free space which is kept ahead of time, in bytes
+            uint64_t shared_memory_forecast() const;
+            uint32_t shared_memory_resize_count() const;
+            /// number of resizes which were forced by bad_alloc during applying of a block
+            uint32_t shared_memory_bad_alloc_count() const;
+            uint32_t last_shared_memory_resize_block_num() const;
+
+            /**
+             * @brief Scan all core and plugin indexes and return bytes taken by each of them.
+             *
+             * Objects are walked by chunks of objects_per_lock objects, each chunk under its own weak read lock,
+             * so the scan can run in a background thread without stalling of applying blocks. The caller
+             * shouldn't hold a lock. As the state changes between chunks, the result is approximate.
+             */
+            std::vector<index_memory_usage> get_index_memory_usage(uint32_t objects_per_lock = 10000);
+
+            /// keep undo telemetry of the last N applied blocks
+            void set_undo_usage_history(uint32_t);
+            /// warn when irreversibility lags the head by N blocks and undo states grow, 0 disables warnings
+            void set_undo_warning_blocks(uint32_t);
+
+            /// undo telemetry of the last applied blocks, the newest first
+            std::vector<undo_state_usage> get_undo_state_usage(uint32_t limit) const;
+
             void set_skip_virtual_ops();
 
             /**
@@ -107,6 +152,12 @@ namespace graphene { namespace chain {
 
             void close(bool rewind = true);
 
+            /**
+             * @brief Write the state of all core indexes at the head block to the directory, each index is
+             * exported by its own thread. Indexes of plugins aren't included, they start empty after import.
+             */
+            void export_state_snapshot(const fc::path &snapshot_dir) const;
+
             //////////////////// db_block.cpp ////////////////////
 
             /**
@@ -125,6 +176,17 @@ namespace graphene { namespace chain {
 
             optional<signed_block> fetch_block_by_number(uint32_t num) const;
 
+            /**
+             * The same as above, but blocks of the fork database are returned without copying,
+             * the block on the main branch is returned if there are several blocks with the number
+             */
+            std::shared_ptr<const signed_block> fetch_shared_block_by_id(const block_id_type &id) const;
+
+            std::shared_ptr<const signed_block> fetch_shared_block_by_number(uint32_t num) const;
+
+            /// packed bytes of a block of the fork database, or empty if the block isn't there
+            std::vector<char> fetch_serialized_reversible_block(const block_id_type &id) const;
+
             const signed_transaction get_recent_transaction(const transaction_id_type &trx_id) const;
 
             std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
@@ -156,6 +218,18 @@ namespace graphene { namespace chain {
 
             const content_type_object *find_content_type(const content_id_type &content) const;
 
+            /**
+             * Texts of content_type_object should be read and written only by these methods,
+             * because they are either in the shared memory file or in the content body store.
+             */
+            std::string get_content_title(const content_type_object &content) const;
+
+            std::string get_content_body(const content_type_object &content) const;
+
+            std::string get_content_json_metadata(const content_type_object &content) const;
+
+            void set_content_text(shared_string &value, uint64_t &blob, const std::string &text);
+
             const escrow_object &get_escrow(const account_name_type &name, uint32_t escrow_id) const;
 
             const escrow_object *find_escrow(const account_name_type &name, uint32_t escrow_id) const;
@@ -194,13 +268,16 @@ namespace graphene { namespace chain {
 
             bool push_block(const signed_block &b, uint32_t skip = skip_nothing);
 
+            /// the block is kept in the fork database as is, without copying
+            bool push_block(const std::shared_ptr<const signed_block> &b, uint32_t skip = skip_nothing);
+
             void enable_plugins_on_push_transaction(bool);
 
             void push_transaction(const signed_transaction &trx, uint32_t skip = skip_nothing);
 
             void _maybe_warn_multiple_production(uint32_t height) const;
 
-            bool _push_block(const signed_block &b, uint32_t skip);
+            bool _push_block(const std::shared_ptr<const signed_block> &b, uint32_t skip);
 
             void _push_transaction(const signed_transaction &trx, uint32_t skip);
 
@@ -447,6 +524,14 @@ namespace graphene { namespace chain {
 
             void _validate_block(const signed_block& next_block, uint32_t skip);
 
+            void check_block_merkle_root(const signed_block& new_block, const checksum_type& merkle_root) const;
+
+            void check_block_size(const signed_block& new_block, size_t block_size) const;
+
+            void prevalidate_block_signee(const signed_block& new_block);
+
+            public_key_type get_block_signee(const signed_block& next_block) const;
+
             void _apply_block(const signed_block &next_block, uint32_t skip);
 
             void _apply_transaction(const signed_transaction &trx, uint32_t skip);
@@ -490,7 +575,13 @@ namespace graphene { namespace chain {
 
             void apply_hardfork(uint32_t hardfork);
 
-            bool _resize(uint32_t block_num);
+            bool _resize(uint32_t block_num, uint64_t min_increase = 0);
+
+            void update_shared_memory_forecast();
+
+            void update_undo_state_usage(uint32_t block_num);
+
+            signed_block import_state_snapshot(const fc::path &snapshot_dir);
 
             ///@}
 
@@ -502,6 +593,9 @@ namespace graphene { namespace chain {
             protocol::hardfork_version _hardfork_versions[CHAIN_NUM_HARDFORKS + 1];
 
             block_log _block_log;
+            content_body_store _content_body_store;
+            bool _store_content_bodies = false;
+            bool _lean_transaction_objects = false;
 
             // this function needs access to _plugin_index_signal
             template<typename MultiIndexType>
@@ -509,6 +603,18 @@ namespace graphene { namespace chain {
 
             fc::signal<void()> _plugin_index_signal;
 
+            // this function needs access to _state_snapshot_indexes
+            template<typename MultiIndexType>
+            friend void add_core_index(database &db);
+
+            std::vector<std::unique_ptr<state_snapshot_index>> _state_snapshot_indexes;
+
+            // this function needs access to _index_memory_accountings
+            template<typename MultiIndexType>
+            friend void _add_index_impl(database &db);
+
+            std::vector<std::unique_ptr<index_memory_accounting>> _index_memory_accountings;
+
             transaction_id_type _current_trx_id;
             uint32_t _current_block_num = 0;
             uint16_t _current_trx_in_block = 0;
@@ -527,6 +633,24 @@ namespace graphene { namespace chain {
 
             uint32_t _block_num_check_free_memory = 1000;
 
+            uint32_t _shared_memory_forecast_blocks = 1200;
+            double _shared_memory_growth_per_block = 0;
+            uint64_t _last_used_memory = 0;
+            uint32_t _shared_memory_resize_count = 0;
+            uint32_t _shared_memory_bad_alloc_count = 0;
+            uint32_t _last_shared_memory_resize_block_num = 0;
+
+            fc::path _shared_mem_dir;
+            shared_memory_mapping_options _shared_memory_mapping_options;
+            shared_memory_mapping_info _shared_memory_mapping_info;
+
+            void apply_shared_memory_mapping(uint64_t prefault_offset = 0);
+
+            std::deque<undo_state_usage> _undo_state_usage;
+            uint32_t _undo_usage_history = 1200;
+            uint32_t _undo_warning_blocks = 100;
+            uint64_t _last_undo_warning_size = 0;
+
             bool _skip_virtual_ops = false;
             bool _enable_plugins_on_push_transaction = false;
 
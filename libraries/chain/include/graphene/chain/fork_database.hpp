@@ -2,6 +2,8 @@
 
 #include <graphene/protocol/block.hpp>
 
+#include <fc/io/raw.hpp>
+
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
@@ -17,13 +19,17 @@ namespace graphene {
         using graphene::protocol::signed_block;
         using graphene::protocol::block_id_type;
 
+        /**
+         * The block is immutable and shared with callers, so it isn't copied on the way from the p2p layer
+         * to applying and to the block log. Its id and packed bytes are calculated once on creation.
+         */
         struct fork_item {
-            fork_item(signed_block d)
-                    : num(d.block_num()), id(d.id()), data(std::move(d)) {
+            fork_item(std::shared_ptr<const signed_block> d)
+                    : num(d->block_num()), id(d->id()), data(std::move(d)), packed(fc::raw::pack(*data)) {
             }
 
             block_id_type previous_id() const {
-                return data.previous;
+                return data->previous;
             }
 
             weak_ptr<fork_item> prev;
@@ -34,7 +40,8 @@ namespace graphene {
              */
             bool invalid = false;
             block_id_type id;
-            signed_block data;
+            std::shared_ptr<const signed_block> data;
+            std::vector<char> packed;
         };
 
         typedef shared_ptr<fork_item> item_ptr;
@@ -60,7 +67,7 @@ namespace graphene {
 
             void reset();
 
-            void start_block(signed_block b);
+            void start_block(std::shared_ptr<const signed_block> b);
 
             void remove(block_id_type b);
 
@@ -75,7 +82,7 @@ namespace graphene {
             /**
              *  @return the new head block ( the longest fork )
              */
-            shared_ptr<fork_item> push_block(const signed_block &b);
+            shared_ptr<fork_item> push_block(const std::shared_ptr<const signed_block> &b);
 
             shared_ptr<fork_item> head() const {
                 return _head;
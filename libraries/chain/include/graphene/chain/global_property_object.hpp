@@ -122,6 +122,12 @@ namespace graphene {
              * The number of accounts who can use bandwidth reserve assigned by witnesses consensus
              */
             uint32_t bandwidth_reserve_candidates = 1;
+
+            /**
+             * The size of the content body store at the head block. The store is append-only and isn't
+             * rolled back with the state, so on open it can't be smaller than this value.
+             */
+            uint64_t content_body_store_size = 0;
         };
 
         typedef multi_index_container <
@@ -161,5 +167,6 @@ FC_REFLECT((graphene::chain::dynamic_global_property_object),
                 (current_reserve_ratio)
                 (vote_regeneration_per_day)
                 (bandwidth_reserve_candidates)
+                (content_body_store_size)
 )
 CHAINBASE_SET_INDEX_TYPE(graphene::chain::dynamic_global_property_object, graphene::chain::dynamic_global_property_index)
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <graphene/chain/database.hpp>
+#include <graphene/chain/index_memory_usage.hpp>
+#include <graphene/chain/state_snapshot.hpp>
 
 namespace graphene {
     namespace chain {
@@ -8,11 +10,13 @@ namespace graphene {
         template<typename MultiIndexType>
         void _add_index_impl(database &db) {
             db.add_index<MultiIndexType>();
+            db._index_memory_accountings.emplace_back(new index_memory_accounting_impl<MultiIndexType>(db));
         }
 
         template<typename MultiIndexType>
         void add_core_index(database &db) {
             _add_index_impl<MultiIndexType>(db);
+            db._state_snapshot_indexes.emplace_back(new state_snapshot_index_impl<MultiIndexType>(db));
         }
 
         template<typename MultiIndexType>
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <graphene/chain/chain_object_types.hpp>
+
+#include <fc/reflect/reflect.hpp>
+
+#include <boost/interprocess/containers/flat_map.hpp>
+#include <boost/interprocess/containers/flat_set.hpp>
+#include <boost/interprocess/containers/vector.hpp>
+#include <boost/multi_index/detail/node_type.hpp>
+#include <boost/core/demangle.hpp>
+
+#include <type_traits>
+#include <typeinfo>
+
+namespace graphene {
+    namespace chain {
+
+        /**
+         *  Bytes of the shared memory file taken by one index:
+         *  - fixed_size is the size of objects themselves,
+         *  - node_overhead is the size of headers of all indices in the multi_index node of each object,
+         *  - dynamic_size is the size of separately allocated members (shared_string, buffer_type, vectors, ...).
+         */
+        struct index_memory_usage {
+            std::string name;
+            uint64_t object_count = 0;
+            uint64_t object_size = 0;
+            uint64_t node_size = 0;
+            uint64_t fixed_size = 0;
+            uint64_t node_overhead = 0;
+            uint64_t dynamic_size = 0;
+            uint64_t total_size = 0;
+        };
+
+        /**
+         *  Objects of one index captured in undo states: created, modified and removed ones are counted
+         *  for the last undo state (the last applied block), retained ones for all undo states.
+         *  Sizes are approximate, they include copies of objects and nodes of undo containers,
+         *  but not separately allocated members of the copies.
+         */
+        struct index_undo_usage {
+            std::string name;
+            uint32_t created = 0;
+            uint32_t modified = 0;
+            uint32_t removed = 0;
+            uint64_t size = 0;
+            uint64_t retained_objects = 0;
+            uint64_t retained_size = 0;
+        };
+
+        /**
+         *  Undo telemetry of one applied block
+         */
+        struct undo_state_usage {
+            uint32_t block_num = 0;
+            uint32_t last_irreversible_block_num = 0;
+            /// number of undo states, i.e. of blocks which can be undone
+            uint32_t undo_depth = 0;
+            uint32_t created = 0;
+            uint32_t modified = 0;
+            uint32_t removed = 0;
+            /// bytes of the undo state of the block
+            uint64_t size = 0;
+            /// bytes of all undo states
+            uint64_t retained_size = 0;
+            /// only indexes with objects in undo states
+            std::vector<index_undo_usage> indexes;
+        };
+
+        /**
+         *  Memory accounting of one index, instances are registered for all core and plugin indexes by _add_index_impl()
+         */
+        class index_memory_accounting {
+        public:
+            virtual ~index_memory_accounting() = default;
+
+            /// fills everything except dynamic_size
+            virtual index_memory_usage get_fixed_usage() const = 0;
+
+            /**
+             *  Adds dynamic sizes of up to max_count objects starting from from_id,
+             *  returns id of the next object or -1 if the end of the index is reached
+             */
+            virtual int64_t add_dynamic_usage(int64_t from_id, uint32_t max_count, uint64_t &dynamic_size) const = 0;
+
+            virtual index_undo_usage get_undo_usage() const = 0;
+
+            virtual uint32_t get_undo_depth() const = 0;
+        };
+
+        namespace detail {
+            namespace bip = boost::interprocess;
+
+            template<typename T>
+            uint64_t dynamic_memory_size(const T &v);
+
+            inline uint64_t dynamic_memory_size(const shared_string &s) {
+                // short strings are kept inside of the string object
+                return s.capacity() + 1 > sizeof(s) ? s.capacity() + 1 : 0;
+            }
+
+            template<typename T, typename A>
+            uint64_t dynamic_memory_size(const bip::vector<T, A> &v) {
+                return v.capacity() * sizeof(T);
+            }
+
+            template<typename K, typename C, typename A>
+            uint64_t dynamic_memory_size(const bip::flat_set<K, C, A> &v) {
+                return v.capacity() * sizeof(K);
+            }
+
+            template<typename K, typename V, typename C, typename A>
+            uint64_t dynamic_memory_size(const bip::flat_map<K, V, C, A> &v) {
+                return v.capacity() * sizeof(std::pair<K, V>);
+            }
+
+            template<typename T>
+            struct dynamic_memory_size_visitor {
+                dynamic_memory_size_visitor(const T &o, uint64_t &s)
+                        : obj(o), size(s) {
+                }
+
+                template<typename Member, class Class, Member (Class::*member)>
+                void operator()(const char *) const {
+                    size += dynamic_memory_size(obj.*member);
+                }
+
+                const T &obj;
+                uint64_t &size;
+            };
+
+            template<typename T>
+            uint64_t dynamic_memory_size_of_members(const T &v, std::true_type) {
+                uint64_t size = 0;
+                fc::reflector<T>::visit(dynamic_memory_size_visitor<T>(v, size));
+                return size;
+            }
+
+            template<typename T>
+            uint64_t dynamic_memory_size_of_members(const T &, std::false_type) {
+                // members of types without reflection can't be walked, enums have nothing to walk
+                return 0;
+            }
+
+            template<typename T>
+            uint64_t dynamic_memory_size(const T &v) {
+                return dynamic_memory_size_of_members(v, std::integral_constant<bool,
+                    fc::reflector<T>::is_defined::value && !std::is_enum<T>::value>());
+            }
+        }
+
+        template<typename MultiIndexType>
+        class index_memory_accounting_impl final: public index_memory_accounting {
+        public:
+            using object_type = typename MultiIndexType::value_type;
+            using node_type = typename boost::multi_index::detail::multi_index_node_type<
+                object_type,
+                typename MultiIndexType::index_specifier_type_list,
+                typename MultiIndexType::allocator_type>::type;
+
+            index_memory_accounting_impl(const chainbase::database &db)
+                    : _db(db), _name(boost::core::demangle(typeid(object_type).name())) {
+            }
+
+            index_memory_usage get_fixed_usage() const override {
+                const auto &indices = _db.get_index<MultiIndexType>().indices();
+
+                index_memory_usage usage;
+                usage.name = _name;
+                usage.object_count = indices.size();
+                usage.object_size = sizeof(object_type);
+                usage.node_size = sizeof(node_type);
+                usage.fixed_size = usage.object_count * usage.object_size;
+                usage.node_overhead = usage.object_count * (usage.node_size - usage.object_size);
+                return usage;
+            }
+
+            int64_t add_dynamic_usage(int64_t from_id, uint32_t max_count, uint64_t &dynamic_size) const override {
+                // the first index of every index is by_id
+                const auto &indices = _db.get_index<MultiIndexType>().indices();
+                auto itr = indices.lower_bound(typename object_type::id_type(from_id));
+                for (uint32_t i = 0; i < max_count && itr != indices.end(); ++i, ++itr) {
+                    dynamic_size += detail::dynamic_memory_size(*itr);
+                }
+                return itr == indices.end() ? -1 : itr->id._id;
+            }
+
+            index_undo_usage get_undo_usage() const override {
+                const auto &stack = _db.get_index<MultiIndexType>().stack();
+
+                index_undo_usage usage;
+                if (stack.empty()) {
+                    return usage;
+                }
+
+                using undo_state_type = typename std::decay<decltype(stack.back())>::type;
+                using value_node_type = typename decltype(undo_state_type::old_values)::value_type;
+                using id_node_type = typename decltype(undo_state_type::new_ids)::value_type;
+                const uint64_t value_size = sizeof(value_node_type) + undo_node_overhead;
+                const uint64_t id_size = sizeof(id_node_type) + undo_node_overhead;
+
+                for (const auto &state: stack) {
+                    const uint64_t values = state.old_values.size() + state.removed_values.size();
+                    usage.retained_objects += values + state.new_ids.size();
+                    usage.retained_size += values * value_size + state.new_ids.size() * id_size;
+                }
+
+                const auto &last = stack.back();
+                usage.name = _name;
+                usage.created = last.new_ids.size();
+                usage.modified = last.old_values.size();
+                usage.removed = last.removed_values.size();
+                usage.size = (usage.modified + usage.removed) * value_size + usage.created * id_size;
+                return usage;
+            }
+
+            uint32_t get_undo_depth() const override {
+                return _db.get_index<MultiIndexType>().stack().size();
+            }
+
+        private:
+            /// parent, left, right and color of a tree node
+            static constexpr uint64_t undo_node_overhead = 4 * sizeof(void *);
+
+            const chainbase::database &_db;
+            std::string _name;
+        };
+
+    }
+} // graphene::chain
+
+FC_REFLECT((graphene::chain::index_memory_usage),
+        (name)(object_count)(object_size)(node_size)(fixed_size)(node_overhead)(dynamic_size)(total_size))
+FC_REFLECT((graphene::chain::index_undo_usage),
+        (name)(created)(modified)(removed)(size)(retained_objects)(retained_size))
+FC_REFLECT((graphene::chain::undo_state_usage),
+        (block_num)(last_irreversible_block_num)(undo_depth)(created)(modified)(removed)(size)(retained_size)(indexes))
@@ -141,5 +141,19 @@ namespace graphene { namespace chain {
 
 } } // graphene::chain
 
+namespace fc {
+    void to_variant(const graphene::chain::proposal_object::name_set_type &s, variant &var);
+    void from_variant(const variant &var, graphene::chain::proposal_object::name_set_type &s);
+
+    void to_variant(const graphene::chain::proposal_object::key_set_type &s, variant &var);
+    void from_variant(const variant &var, graphene::chain::proposal_object::key_set_type &s);
+}
+
+FC_REFLECT((graphene::chain::proposal_object),
+    (id)(author)(title)(memo)(expiration_time)(review_period_time)(proposed_operations)
+    (required_active_approvals)(available_active_approvals)(required_owner_approvals)(available_owner_approvals)
+    (required_posting_approvals)(available_posting_approvals)(available_key_approvals))
 CHAINBASE_SET_INDEX_TYPE(graphene::chain::proposal_object, graphene::chain::proposal_index);
+
+FC_REFLECT((graphene::chain::required_approval_object), (id)(account)(proposal))
 CHAINBASE_SET_INDEX_TYPE(graphene::chain::required_approval_object, graphene::chain::required_approval_index);
\ No newline at end of file
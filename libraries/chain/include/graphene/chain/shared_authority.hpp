@@ -108,5 +108,14 @@ namespace graphene {
     }
 } //graphene::chain
 
+namespace fc {
+    class variant;
+
+    /// shared_authority is converted through authority, so its flat maps keep their shared memory allocators
+    void to_variant(const graphene::chain::shared_authority &a, variant &var);
+
+    void from_variant(const variant &var, graphene::chain::shared_authority &a);
+}
+
 FC_REFLECT_TYPENAME((graphene::chain::shared_authority::account_authority_map))
 FC_REFLECT((graphene::chain::shared_authority), (weight_threshold)(account_auths)(key_auths))
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <string>
+
+namespace graphene {
+    namespace chain {
+
+        /**
+         *  How the mapping of the shared memory file is tuned after it is opened or resized.
+         *  The file itself can be placed on hugetlbfs by shared-file-dir, then its size is rounded to huge pages.
+         *  Transparent huge pages are used by the kernel only for files on tmpfs (e.g. /dev/shm) with huge pages enabled.
+         */
+        struct shared_memory_mapping_options {
+            bool transparent_huge_pages = false;
+            /// read all pages of the file in advance, so block application doesn't wait for page faults
+            bool prefault = false;
+            /// lock pages in memory, RLIMIT_MEMLOCK should allow it
+            bool lock = false;
+            /// prefer memory of the NUMA node for pages of the file, -1 to keep the default policy
+            int32_t numa_node = -1;
+        };
+
+        /**
+         *  The effective state of the mapping, which is reported at startup and after resizes
+         */
+        struct shared_memory_mapping_info {
+            std::string file_system;
+            uint64_t page_size = 0;
+            /// bytes of the mapping which are backed by huge pages
+            uint64_t huge_pages_size = 0;
+            bool locked = false;
+            int32_t numa_node = -1;
+        };
+
+        /**
+         *  Return the huge page size if dir is on hugetlbfs, otherwise 0
+         */
+        uint64_t hugetlbfs_page_size(const fc::path &dir);
+
+        /**
+         *  Throw if dir is on hugetlbfs and has files other than the shared memory file: hugetlbfs supports only
+         *  mapping of whole huge pages, files written by write(2) or resized to other sizes can't be there
+         */
+        void check_hugetlbfs_dir(const fc::path &dir);
+
+        /**
+         *  Apply options to the mapping [addr, addr + size) of the file in dir, errors are logged and don't stop the node.
+         *  Only [addr + prefault_offset, addr + size) is prefaulted, the rest is expected to be in memory already
+         */
+        shared_memory_mapping_info apply_shared_memory_mapping_options(
+            void *addr, uint64_t size, const fc::path &dir, const shared_memory_mapping_options &options,
+            uint64_t prefault_offset = 0);
+
+    }
+} // graphene::chain
+
+FC_REFLECT((graphene::chain::shared_memory_mapping_options), (transparent_huge_pages)(prefault)(lock)(numa_node))
+FC_REFLECT((graphene::chain::shared_memory_mapping_info), (file_system)(page_size)(huge_pages_size)(locked)(numa_node))
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <graphene/chain/database.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
+#include <fc/reflect/variant.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <fstream>
+
+namespace graphene {
+    namespace chain {
+
+        /**
+         *  One index of a state snapshot: the objects are stored in their own file in order of ids,
+         *  each one as a packed fc::variant, so the file doesn't depend on the memory layout of objects
+         */
+        struct state_snapshot_section {
+            std::string name;
+            uint64_t objects = 0;
+            uint64_t size = 0;
+            fc::sha256 hash;
+        };
+
+        /**
+         *  The header of a state snapshot, it's saved as snapshot.json near the files of the sections.
+         *  The content hash covers the whole header including the hashes of the sections.
+         *  Texts of contents, which are referred by handles, are saved in the copy of the content body store.
+         */
+        struct state_snapshot_header {
+            static const uint32_t current_version = 1;
+            /// room for nodes of all indexes and allocator headers of one object in the shared memory file
+            static const uint64_t object_overhead = 512;
+
+            uint32_t version = current_version;
+            chain_id_type chain_id;
+            block_id_type block_id;
+            signed_block block;
+            std::vector<state_snapshot_section> sections;
+            state_snapshot_section content_bodies;
+            fc::sha256 content_hash;
+
+            fc::sha256 digest() const;
+
+            /**
+             *  Size of the shared memory file which fits all objects of the snapshot: a packed variant
+             *  is larger than the fields of its object, the index nodes are counted by object_overhead
+             */
+            uint64_t shared_memory_size() const;
+        };
+
+        /**
+         *  Exports and imports the objects of one core index, instances are registered by add_core_index()
+         */
+        class state_snapshot_index {
+        public:
+            virtual ~state_snapshot_index() = default;
+
+            virtual std::string name() const = 0;
+
+            virtual state_snapshot_section export_section(const fc::path &file) const = 0;
+
+            virtual void import_section(const fc::path &file, const state_snapshot_section &section) = 0;
+        };
+
+        template<typename MultiIndexType>
+        class state_snapshot_index_impl final: public state_snapshot_index {
+        public:
+            using object_type = typename MultiIndexType::value_type;
+
+            state_snapshot_index_impl(database &db)
+                    : _db(db) {
+            }
+
+            std::string name() const override {
+                std::string name = fc::get_typename<object_type>::name();
+                auto pos = name.rfind("::");
+                return pos == std::string::npos ? name : name.substr(pos + 2);
+            }
+
+            state_snapshot_section export_section(const fc::path &file) const override {
+                state_snapshot_section section;
+                section.name = name();
+
+                std::ofstream out(file.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+                FC_ASSERT(out.good(), "Can't create ${file}", ("file", file));
+
+                fc::sha256::encoder encoder;
+                // the first index of every core index is by_id, so objects are written in order of ids
+                for (const auto &o: _db.get_index<MultiIndexType>().indices()) {
+                    fc::variant var;
+                    fc::to_variant(o, var);
+                    auto data = fc::raw::pack(var);
+                    out.write(data.data(), data.size());
+                    encoder.write(data.data(), data.size());
+                    section.objects++;
+                    section.size += data.size();
+                }
+
+                out.close();
+                FC_ASSERT(!out.fail(), "Can't write ${file}", ("file", file));
+
+                section.hash = encoder.result();
+                return section;
+            }
+
+            void import_section(const fc::path &file, const state_snapshot_section &section) override {
+                FC_ASSERT(_db.get_index<MultiIndexType>().indices().empty(),
+                    "Index ${name} isn't empty", ("name", section.name));
+                if (section.objects == 0) {
+                    return;
+                }
+
+                boost::iostreams::mapped_file_source mapped_file(file.string());
+                FC_ASSERT(mapped_file.size() == section.size,
+                    "Size of ${file} doesn't match the snapshot header", ("file", file));
+                FC_ASSERT(fc::sha256::hash(mapped_file.data(), mapped_file.size()) == section.hash,
+                    "Hash of ${file} doesn't match the snapshot header", ("file", file));
+
+                fc::datastream<const char *> ds(mapped_file.data(), mapped_file.size());
+                for (uint64_t i = 0; i < section.objects; ++i) {
+                    fc::variant var;
+                    fc::raw::unpack(ds, var);
+                    import_object(var);
+                }
+                FC_ASSERT(ds.remaining() == 0, "Unexpected data at the end of ${file}", ("file", file));
+            }
+
+        private:
+            /**
+             *  Objects keep their ids, because other objects refer to them. Chainbase always assigns the
+             *  next id on create, so a gap of removed ids (e.g. of old transactions or votes) is skipped
+             *  by moving the next id of the index straight to the id of the object.
+             */
+            void import_object(const fc::variant &var) {
+                typename object_type::id_type id;
+                fc::from_variant(var["id"], id);
+                // the first object sets the next id too, the index may have used ids before it was emptied
+                FC_ASSERT(!_next_id || !(id < *_next_id), "Objects of ${name} aren't ordered by id", ("name", name()));
+                if (!_next_id || *_next_id < id) {
+                    set_next_id(id);
+                }
+
+                const auto &o = _db.create<object_type>([&](object_type &o) {
+                    auto assigned_id = o.id;
+                    fc::from_variant(var, o);
+                    o.id = assigned_id;
+                });
+                FC_ASSERT(o.id == id, "Object ${id} of ${name} got another id", ("id", id)("name", name()));
+                _next_id = typename object_type::id_type(id._id + 1);
+            }
+
+            /**
+             *  Chainbase has no setter of the next id, but undo of a session restores the next id which
+             *  was saved in its undo state. The session is empty, so nothing else is changed by the undo.
+             *  This depends on internals of the chainbase version pinned in thirdparty/chainbase:
+             *  generic_index::undo() assigns undo_state::old_next_id to the next id. Check it when
+             *  the submodule is updated, or replace it with a setter once chainbase has one.
+             */
+            void set_next_id(typename object_type::id_type id) {
+                auto &index = _db.get_mutable_index<MultiIndexType>();
+                auto session = index.start_undo_session(true);
+                using undo_state_type = typename chainbase::generic_index<MultiIndexType>::undo_state_type;
+                const_cast<undo_state_type &>(index.stack().back()).old_next_id = id;
+                session.undo();
+            }
+
+            fc::optional<typename object_type::id_type> _next_id;
+            database &_db;
+        };
+
+    }
+} // graphene::chain
+
+FC_REFLECT((graphene::chain::state_snapshot_section), (name)(objects)(size)(hash))
+FC_REFLECT((graphene::chain::state_snapshot_header), (version)(chain_id)(block_id)(block)(sections)(content_bodies)(content_hash))
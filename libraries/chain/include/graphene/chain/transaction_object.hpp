@@ -15,6 +15,9 @@ namespace graphene {
          * The purpose of this object is to enable the detection of duplicate transactions. When a transaction is included
          * in a block a transaction_object is added. At the end of block processing all transaction_objects that have
          * expired can be removed from the index.
+         *
+         * The packed transaction is empty in the lean mode, then only trx_id, expiration and number of the block
+         * which includes the transaction are kept.
          */
         class transaction_object
                 : public object<transaction_object_type, transaction_object> {
@@ -32,6 +35,7 @@ namespace graphene {
             bip::vector<char, allocator<char>> packed_trx;
             transaction_id_type trx_id;
             time_point_sec expiration;
+            uint32_t block_num = 0;
         };
 
         struct by_expiration;
@@ -51,5 +55,5 @@ namespace graphene {
     }
 } // graphene::chain
 
-FC_REFLECT((graphene::chain::transaction_object), (id)(packed_trx)(trx_id)(expiration))
+FC_REFLECT((graphene::chain::transaction_object), (id)(packed_trx)(trx_id)(expiration)(block_num))
 CHAINBASE_SET_INDEX_TYPE(graphene::chain::transaction_object, graphene::chain::transaction_index)
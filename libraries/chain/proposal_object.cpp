@@ -76,4 +76,36 @@ namespace graphene { namespace chain {
             active_approvals, owner_approvals, posting_approvals);
     }
 
-} } // graphene::chain
\ No newline at end of file
+} } // graphene::chain
+
+namespace fc {
+    namespace {
+        template <typename S> void shared_set_to_variant(const S& s, variant& var) {
+            to_variant(fc::flat_set<typename S::value_type>(s.begin(), s.end()), var);
+        }
+
+        template <typename S> void shared_set_from_variant(const variant& var, S& s) {
+            // the set keeps its shared memory allocator, only the items are replaced
+            s.clear();
+            for (const auto& item: var.as<fc::flat_set<typename S::value_type>>()) {
+                s.insert(item);
+            }
+        }
+    }
+
+    void to_variant(const graphene::chain::proposal_object::name_set_type &s, variant &var) {
+        shared_set_to_variant(s, var);
+    }
+
+    void from_variant(const variant &var, graphene::chain::proposal_object::name_set_type &s) {
+        shared_set_from_variant(var, s);
+    }
+
+    void to_variant(const graphene::chain::proposal_object::key_set_type &s, variant &var) {
+        shared_set_to_variant(s, var);
+    }
+
+    void from_variant(const variant &var, graphene::chain::proposal_object::key_set_type &s) {
+        shared_set_from_variant(var, s);
+    }
+}
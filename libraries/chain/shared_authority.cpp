@@ -96,3 +96,13 @@ namespace graphene {
 
     }
 } // graphene::chain
+
+namespace fc {
+    void to_variant(const graphene::chain::shared_authority &a, variant &var) {
+        to_variant(graphene::chain::authority(a), var);
+    }
+
+    void from_variant(const variant &var, graphene::chain::shared_authority &a) {
+        a = var.as<graphene::chain::authority>();
+    }
+}
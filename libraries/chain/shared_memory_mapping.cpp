@@ -0,0 +1,178 @@
+#include <graphene/chain/shared_memory_mapping.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+#include <fc/time.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/statfs.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace graphene { namespace chain {
+    namespace {
+#ifdef __linux__
+        constexpr long hugetlbfs_magic = 0x958458f6;
+        constexpr long tmpfs_magic = 0x01021994;
+        constexpr int mpol_preferred = 1;
+        constexpr unsigned mpol_mf_move = 1 << 1;
+
+        /**
+         *  Sums sizes of huge pages of the mapping which contains addr from /proc/self/smaps
+         */
+        void read_smaps(void *addr, shared_memory_mapping_info &info) {
+            std::ifstream smaps("/proc/self/smaps");
+            const auto target = reinterpret_cast<uintptr_t>(addr);
+            bool found = false;
+            std::string line;
+            while (std::getline(smaps, line)) {
+                uintptr_t begin = 0;
+                uintptr_t end = 0;
+                char dash = 0;
+                std::istringstream header(line);
+                if (header >> std::hex >> begin >> dash >> end && dash == '-') {
+                    if (found) {
+                        break;
+                    }
+                    found = (begin <= target && target < end);
+                    continue;
+                }
+                if (!found) {
+                    continue;
+                }
+
+                std::istringstream field(line);
+                std::string name;
+                uint64_t kb = 0;
+                field >> name >> kb;
+                if (name == "KernelPageSize:") {
+                    info.page_size = kb * 1024;
+                } else if (name == "AnonHugePages:" || name == "ShmemPmdMapped:" || name == "FilePmdMapped:") {
+                    info.huge_pages_size += kb * 1024;
+                }
+            }
+        }
+#endif
+    }
+
+    uint64_t hugetlbfs_page_size(const fc::path &dir) {
+#ifdef __linux__
+        struct statfs fs;
+        if (statfs(dir.string().c_str(), &fs) == 0 && long(fs.f_type) == hugetlbfs_magic) {
+            return fs.f_bsize;
+        }
+#endif
+        return 0;
+    }
+
+    void check_hugetlbfs_dir(const fc::path &dir) {
+        if (hugetlbfs_page_size(dir) == 0) {
+            return;
+        }
+        for (boost::filesystem::directory_iterator itr(dir.string()), end; itr != end; ++itr) {
+            // chainbase keeps the shared memory file and its meta data as shared_memory.*
+            const auto name = itr->path().filename().string();
+            FC_ASSERT(name.compare(0, 13, "shared_memory") == 0,
+                "Only the shared memory file can be in shared-file-dir on hugetlbfs, found ${name} in ${dir}",
+                ("name", name)("dir", dir));
+        }
+    }
+
+    shared_memory_mapping_info apply_shared_memory_mapping_options(
+        void *addr, uint64_t size, const fc::path &dir, const shared_memory_mapping_options &options,
+        uint64_t prefault_offset
+    ) {
+        shared_memory_mapping_info info;
+#ifdef __linux__
+        const uint64_t system_page_size = sysconf(_SC_PAGESIZE);
+        // the segment manager is at the start of the mapping, only the header can be before it
+        auto *begin = reinterpret_cast<char *>(reinterpret_cast<uintptr_t>(addr) & ~(system_page_size - 1));
+        size += static_cast<char *>(addr) - begin;
+        prefault_offset = (prefault_offset + (static_cast<char *>(addr) - begin)) & ~(system_page_size - 1);
+
+        struct statfs fs;
+        if (statfs(dir.string().c_str(), &fs) == 0) {
+            if (long(fs.f_type) == hugetlbfs_magic) {
+                info.file_system = "hugetlbfs";
+            } else if (long(fs.f_type) == tmpfs_magic) {
+                info.file_system = "tmpfs";
+            } else {
+                info.file_system = "other";
+            }
+        }
+
+        if (options.transparent_huge_pages && madvise(begin, size, MADV_HUGEPAGE) != 0) {
+            wlog("Can't use transparent huge pages for shared memory file: ${e}", ("e", std::strerror(errno)));
+        }
+
+        if (options.numa_node >= 0) {
+            const unsigned long max_node = sizeof(unsigned long) * 8;
+            if (uint32_t(options.numa_node) >= max_node) {
+                wlog("NUMA node ${n} is out of range", ("n", options.numa_node));
+            } else {
+                // pages, which are already in memory, are moved to the node too
+                unsigned long node_mask = 1ul << options.numa_node;
+                if (syscall(SYS_mbind, begin, size, mpol_preferred, &node_mask, max_node, mpol_mf_move) == 0) {
+                    info.numa_node = options.numa_node;
+                } else {
+                    wlog("Can't bind shared memory file to NUMA node ${n}: ${e}",
+                         ("n", options.numa_node)("e", std::strerror(errno)));
+                }
+            }
+        }
+
+        if (options.prefault && prefault_offset < size) {
+            auto start = fc::time_point::now();
+            auto *prefault_begin = begin + prefault_offset;
+            const uint64_t prefault_size = size - prefault_offset;
+            bool populated = false;
+            if (info.file_system == "tmpfs" || info.file_system == "hugetlbfs") {
+#ifdef MADV_POPULATE_WRITE
+                // maps pages writable at once, so the first write in block application has no fault too
+                populated = (madvise(prefault_begin, prefault_size, MADV_POPULATE_WRITE) == 0);
+#endif
+            } else {
+#ifdef MADV_POPULATE_READ
+                // writable population of a file on disk would dirty all its pages and write them back
+                populated = (madvise(prefault_begin, prefault_size, MADV_POPULATE_READ) == 0);
+#endif
+            }
+            if (!populated) {
+                madvise(prefault_begin, prefault_size, MADV_WILLNEED);
+                // reading of one byte per page brings the whole file into the page cache and maps it
+                volatile char sum = 0;
+                for (uint64_t offset = 0; offset < prefault_size; offset += system_page_size) {
+                    sum += prefault_begin[offset];
+                }
+                (void)sum;
+            }
+            ilog("Prefaulted ${mem}M of shared memory file in ${t} sec",
+                 ("mem", prefault_size / (1024 * 1024))("t", double((fc::time_point::now() - start).count()) / 1000000.0));
+        }
+
+        if (options.lock) {
+            if (mlock(begin, size) == 0) {
+                info.locked = true;
+            } else {
+                wlog("Can't lock shared memory file in memory: ${e}, check RLIMIT_MEMLOCK", ("e", std::strerror(errno)));
+            }
+        }
+
+        read_smaps(begin, info);
+        if (info.page_size == 0) {
+            info.page_size = system_page_size;
+        }
+#endif
+        return info;
+    }
+
+} } // graphene::chain
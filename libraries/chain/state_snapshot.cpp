@@ -0,0 +1,123 @@
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/state_snapshot.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <future>
+
+namespace graphene { namespace chain {
+
+    fc::sha256 state_snapshot_header::digest() const {
+        auto tmp = *this;
+        tmp.content_hash = fc::sha256();
+        return fc::sha256::hash(tmp);
+    }
+
+    uint64_t state_snapshot_header::shared_memory_size() const {
+        uint64_t result = 0;
+        for (const auto &section: sections) {
+            result += section.size + section.objects * object_overhead;
+        }
+        return result;
+    }
+
+    void database::export_state_snapshot(const fc::path &snapshot_dir) const { try {
+        auto start = fc::time_point::now();
+
+        auto head_block = fetch_block_by_id(head_block_id());
+        FC_ASSERT(head_block.valid(), "Head block ${id} is unknown", ("id", head_block_id()));
+
+        wlog("Start exporting state snapshot of block ${n} to ${dir}", ("n", head_block_num())("dir", snapshot_dir));
+        fc::create_directories(snapshot_dir);
+
+        state_snapshot_header header;
+        header.chain_id = get_chain_id();
+        header.block_id = head_block_id();
+        header.block = std::move(*head_block);
+
+        std::vector<std::future<state_snapshot_section>> tasks;
+        tasks.reserve(_state_snapshot_indexes.size());
+        for (const auto &index: _state_snapshot_indexes) {
+            const auto *ptr = index.get();
+            tasks.push_back(std::async(std::launch::async, [ptr, &snapshot_dir]() {
+                return ptr->export_section(snapshot_dir / (ptr->name() + ".bin"));
+            }));
+        }
+        for (auto &task: tasks) {
+            header.sections.push_back(task.get());
+        }
+
+        auto content_bodies_file = snapshot_dir / "content_bodies.bin";
+        _content_body_store.export_to(content_bodies_file);
+        {
+            boost::iostreams::mapped_file_source mapped_file(content_bodies_file.string());
+            header.content_bodies.name = "content_bodies";
+            header.content_bodies.size = mapped_file.size();
+            header.content_bodies.hash = fc::sha256::hash(mapped_file.data(), mapped_file.size());
+        }
+
+        header.content_hash = header.digest();
+        fc::json::save_to_file(header, snapshot_dir / "snapshot.json");
+
+        auto end = fc::time_point::now();
+        wlog("Done exporting state snapshot, content hash ${hash}, elapsed time ${t} sec",
+             ("hash", header.content_hash)("t", double((end - start).count()) / 1000000.0));
+    } FC_CAPTURE_AND_RETHROW((snapshot_dir)) }
+
+    signed_block database::import_state_snapshot(const fc::path &snapshot_dir) { try {
+        auto start = fc::time_point::now();
+
+        auto header = fc::json::from_file(snapshot_dir / "snapshot.json").as<state_snapshot_header>();
+
+        FC_ASSERT(header.version == state_snapshot_header::current_version,
+            "Unsupported state snapshot version ${v}", ("v", header.version));
+        FC_ASSERT(header.chain_id == get_chain_id(), "State snapshot is made for another chain ${id}", ("id", header.chain_id));
+        FC_ASSERT(header.block.id() == header.block_id, "Block of state snapshot doesn't match its id");
+        FC_ASSERT(header.content_hash == header.digest(), "Content hash of state snapshot doesn't match its header");
+        FC_ASSERT(header.sections.size() == _state_snapshot_indexes.size(),
+            "State snapshot has ${n} indexes, expected ${e}",
+            ("n", header.sections.size())("e", _state_snapshot_indexes.size()));
+
+        for (size_t i = 0; i < header.sections.size(); ++i) {
+            FC_ASSERT(header.sections[i].name == _state_snapshot_indexes[i]->name(),
+                "State snapshot has index ${name} instead of ${expected}",
+                ("name", header.sections[i].name)("expected", _state_snapshot_indexes[i]->name()));
+        }
+
+        wlog("Start importing state snapshot of block ${n} from ${dir}", ("n", header.block.block_num())("dir", snapshot_dir));
+
+        auto content_bodies_file = snapshot_dir / "content_bodies.bin";
+        {
+            boost::iostreams::mapped_file_source mapped_file(content_bodies_file.string());
+            FC_ASSERT(mapped_file.size() == header.content_bodies.size &&
+                      fc::sha256::hash(mapped_file.data(), mapped_file.size()) == header.content_bodies.hash,
+                "Content body store ${file} doesn't match the snapshot header", ("file", content_bodies_file));
+        }
+        _content_body_store.import_from(content_bodies_file);
+
+        // indexes don't depend on each other and allocations in the shared memory segment are synchronized,
+        // so each index is filled by its own thread while the caller holds the write lock.
+        // The file can't be resized while threads allocate in it, open() has sized it for the whole snapshot
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(header.sections.size());
+        for (size_t i = 0; i < header.sections.size(); ++i) {
+            auto *index = _state_snapshot_indexes[i].get();
+            const auto &section = header.sections[i];
+            tasks.push_back(std::async(std::launch::async, [index, &section, &snapshot_dir]() {
+                index->import_section(snapshot_dir / (section.name + ".bin"), section);
+            }));
+        }
+        for (auto &task: tasks) {
+            task.get();
+        }
+
+        FC_ASSERT(head_block_id() == header.block_id, "Imported state doesn't match block of state snapshot");
+        set_revision(head_block_num());
+
+        auto end = fc::time_point::now();
+        wlog("Done importing state snapshot, elapsed time ${t} sec", ("t", double((end - start).count()) / 1000000.0));
+
+        return header.block;
+    } FC_CAPTURE_AND_RETHROW((snapshot_dir)) }
+
+} } // graphene::chain
@@ -81,6 +81,29 @@
 
 #define GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING      200
 
+/**
+ * The number of sync blocks requested from a peer at a time starts at
+ * GRAPHENE_NET_INITIAL_SYNC_WINDOW.  It grows while the peer delivers a batch
+ * within GRAPHENE_NET_SYNC_BATCH_TARGET_DURATION_MS, and it halves when the
+ * peer needs more than twice that.  It never drops below
+ * GRAPHENE_NET_MIN_SYNC_WINDOW or grows past the blocks-per-peer limit.
+ */
+#define GRAPHENE_NET_INITIAL_SYNC_WINDOW                     50
+#define GRAPHENE_NET_MIN_SYNC_WINDOW                         10
+#define GRAPHENE_NET_SYNC_BATCH_TARGET_DURATION_MS           2000
+
+/**
+ * The packed blocks of a single block_range_message are limited to this size,
+ * which leaves room for the length prefixes inside MAX_MESSAGE_SIZE
+ */
+#define GRAPHENE_NET_MAX_BLOCK_RANGE_SIZE_IN_BYTES           (MAX_MESSAGE_SIZE - 16 * 1024)
+
+/**
+ * Block and transaction messages smaller than this are sent uncompressed even
+ * to peers which accept compressed messages, zlib doesn't gain much on them
+ */
+#define GRAPHENE_NET_DEFAULT_MESSAGE_COMPRESSION_THRESHOLD   1024
+
 /**
  * During normal operation, how many items will be fetched from each
  * peer at a time.  This will only come into play when the network
@@ -103,3 +126,16 @@
 #define GRAPHENE_NET_MIN_BLOCK_IDS_TO_PREFETCH               10000
 
 #define GRAPHENE_NET_MAX_TRX_PER_SECOND                      1000
+
+/**
+ * New transactions are advertised to peers in batches collected over this interval,
+ * blocks are advertised right away
+ */
+#define GRAPHENE_NET_DEFAULT_TRANSACTION_ADVERTISEMENT_INTERVAL_MS  100
+
+/**
+ * Size of the per-peer filter of transactions the peer is known to have, it remembers
+ * at least this many of the most recent ones
+ */
+#define GRAPHENE_NET_KNOWN_TRANSACTIONS_FILTER_SIZE          20000
+#define GRAPHENE_NET_KNOWN_TRANSACTIONS_FILTER_BITS_PER_ITEM 16
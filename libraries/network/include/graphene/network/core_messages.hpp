@@ -38,6 +38,7 @@
 
 
 #include <vector>
+#include <cstring>
 
 namespace graphene {
     namespace network {
@@ -89,6 +90,12 @@ namespace graphene {
             check_firewall_reply_message_type = 5015,
             get_current_connections_request_message_type = 5016,
             get_current_connections_reply_message_type = 5017,
+            compact_block_message_type = 5018,
+            get_compact_block_transactions_message_type = 5019,
+            compact_block_transactions_message_type = 5020,
+            fetch_block_range_message_type = 5021,
+            block_range_message_type = 5022,
+            compressed_message_type = 5023,
             core_message_type_last = 5099
         };
 
@@ -419,6 +426,134 @@ namespace graphene {
             std::vector<current_connection_data> current_connections;
         };
 
+        /**
+         * Short id of a transaction inside a compact_block_message: the leading 8 bytes of the
+         * hash of the trx_message the transaction was relayed (and cached) as
+         */
+        inline uint64_t get_short_transaction_id(const item_hash_t &trx_message_hash) {
+            uint64_t short_id;
+            memcpy(&short_id, trx_message_hash.data(), sizeof(short_id));
+            return short_id;
+        }
+
+        /**
+         * Sent instead of a block_message to peers which announced "compact_blocks" in their
+         * hello user_data.  The receiver rebuilds the block from transactions it already has
+         * in its message cache and asks only for the missing ones.
+         */
+        struct compact_block_message {
+            static const core_message_type_enum type;
+
+            /** hash of the block_message this compact block stands for, as it was advertised */
+            item_hash_t message_hash;
+            graphene::protocol::signed_block_header header;
+            std::vector<uint64_t> short_transaction_ids;
+
+            compact_block_message() {
+            }
+
+            compact_block_message(const item_hash_t &message_hash, const graphene::protocol::signed_block_header &header,
+                    std::vector<uint64_t> short_transaction_ids) :
+                    message_hash(message_hash),
+                    header(header),
+                    short_transaction_ids(std::move(short_transaction_ids)) {
+            }
+        };
+
+        struct get_compact_block_transactions_message {
+            static const core_message_type_enum type;
+
+            item_hash_t message_hash;
+            std::vector<uint32_t> transaction_indexes;
+
+            get_compact_block_transactions_message() {
+            }
+
+            get_compact_block_transactions_message(const item_hash_t &message_hash,
+                    const std::vector<uint32_t> &transaction_indexes) :
+                    message_hash(message_hash),
+                    transaction_indexes(transaction_indexes) {
+            }
+        };
+
+        struct compact_block_transactions_message {
+            static const core_message_type_enum type;
+
+            item_hash_t message_hash;
+            std::vector<signed_transaction> transactions;
+        };
+
+        /**
+         * Sync request for a contiguous run of blocks, sent instead of fetch_items_message to peers
+         * which announced "block_ranges" in their hello user_data
+         */
+        struct fetch_block_range_message {
+            static const core_message_type_enum type;
+
+            uint32_t first_block_num;
+            uint32_t block_count;
+
+            fetch_block_range_message() {
+            }
+
+            fetch_block_range_message(uint32_t first_block_num, uint32_t block_count) :
+                    first_block_num(first_block_num),
+                    block_count(block_count) {
+            }
+        };
+
+        /**
+         * Reply to fetch_block_range_message: packed signed_blocks exactly as the serving node keeps them
+         * in its block log.  It can hold fewer blocks than requested (message size limit, or blocks
+         * which are not irreversible on the serving node yet), the rest should be fetched by id.
+         */
+        struct block_range_message {
+            static const core_message_type_enum type;
+
+            uint32_t first_block_num;
+            std::vector<std::vector<char>> packed_blocks;
+
+            block_range_message() {
+            }
+
+            block_range_message(uint32_t first_block_num, std::vector<std::vector<char>> packed_blocks) :
+                    first_block_num(first_block_num),
+                    packed_blocks(std::move(packed_blocks)) {
+            }
+        };
+
+        /**
+         * Codecs a peer can announce in the "compression" list of its hello user_data
+         */
+        enum message_compression_codec {
+            no_compression = 0,
+            zlib_compression = 1
+        };
+
+        /**
+         * Wraps the data of another message compressed with one of the codecs the receiving peer announced.
+         * The receiver restores the original message byte for byte, so its id doesn't change.
+         */
+        struct compressed_message {
+            static const core_message_type_enum type;
+
+            uint8_t codec;
+            uint32_t original_msg_type;
+            uint32_t original_size;
+            std::vector<char> compressed_data;
+
+            compressed_message() {
+            }
+
+            compressed_message(message_compression_codec codec, uint32_t original_msg_type, uint32_t original_size,
+                    std::vector<char> compressed_data) :
+                    codec(codec),
+                    original_msg_type(original_msg_type),
+                    original_size(original_size),
+                    compressed_data(std::move(compressed_data)) {
+            }
+        };
+
 
     }
 } // graphene::network
@@ -444,6 +579,12 @@ FC_REFLECT_ENUM(graphene::network::core_message_type_enum,
                 (check_firewall_reply_message_type)
                 (get_current_connections_request_message_type)
                 (get_current_connections_reply_message_type)
+                (compact_block_message_type)
+                (get_compact_block_transactions_message_type)
+                (compact_block_transactions_message_type)
+                (fetch_block_range_message_type)
+                (block_range_message_type)
+                (compressed_message_type)
                 (core_message_type_last))
 
 FC_REFLECT((graphene::network::trx_message), (trx))
@@ -527,6 +668,21 @@ FC_REFLECT((graphene::network::get_current_connections_reply_message), (upload_r
         (upload_rate_one_hour)
         (download_rate_one_hour)
         (current_connections))
+FC_REFLECT((graphene::network::compact_block_message), (message_hash)
+        (header)
+        (short_transaction_ids))
+FC_REFLECT((graphene::network::get_compact_block_transactions_message), (message_hash)
+        (transaction_indexes))
+FC_REFLECT((graphene::network::compact_block_transactions_message), (message_hash)
+        (transactions))
+FC_REFLECT((graphene::network::fetch_block_range_message), (first_block_num)
+        (block_count))
+FC_REFLECT((graphene::network::block_range_message), (first_block_num)
+        (packed_blocks))
+FC_REFLECT((graphene::network::compressed_message), (codec)
+        (original_msg_type)
+        (original_size)
+        (compressed_data))
 
 #include <unordered_map>
 #include <fc/crypto/city.hpp>
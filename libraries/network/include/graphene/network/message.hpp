@@ -29,6 +29,9 @@
 #include <fc/io/raw.hpp>
 #include <fc/crypto/ripemd160.hpp>
 #include <fc/reflect/variant.hpp>
+#include <fc/optional.hpp>
+
+#include <memory>
 
 namespace graphene {
     namespace network {
@@ -52,18 +55,29 @@ namespace graphene {
          */
         struct message : public message_header {
             std::vector<char> data;
+            /// size of the compressed message this one was received as, 0 if it was received uncompressed
+            uint32_t compressed_size = 0;
 
             message() {
             }
 
             message(message &&m)
-                    : message_header(m), data(std::move(m.data)) {
+                    : message_header(m), data(std::move(m.data)), compressed_size(m.compressed_size),
+                      _precomputed_id(std::move(m._precomputed_id)), _unpacked(std::move(m._unpacked)),
+                      _unpacked_type(m._unpacked_type), _compressed(std::move(m._compressed)),
+                      _compressed_codec(m._compressed_codec) {
             }
 
             message(const message &m)
-                    : message_header(m), data(m.data) {
+                    : message_header(m), data(m.data), compressed_size(m.compressed_size),
+                      _precomputed_id(m._precomputed_id), _unpacked(m._unpacked), _unpacked_type(m._unpacked_type),
+                      _compressed(m._compressed), _compressed_codec(m._compressed_codec) {
             }
 
+            message &operator=(message &&m) = default;
+
+            message &operator=(const message &m) = default;
+
             /**
              *  Assumes that T::type specifies the message type
              */
@@ -75,9 +89,51 @@ namespace graphene {
             }
 
             fc::uint160_t id() const {
+                if (_precomputed_id) {
+                    return *_precomputed_id;
+                }
                 return fc::ripemd160::hash(data.data(), (uint32_t)data.size());
             }
 
+            /**
+             *  Hashes (and unpacks) a received message ahead of time on a read worker thread,
+             *  id() and as<T>() return these results instead of doing the work again
+             */
+            void precompute_id() {
+                _precomputed_id = fc::ripemd160::hash(data.data(), (uint32_t)data.size());
+            }
+
+            template<typename T>
+            void precompute() {
+                _unpacked = std::make_shared<const T>(as<T>());
+                _unpacked_type = T::type;
+            }
+
+            /**
+             *  Releases the unpacked message, so a long living copy keeps only the packed bytes
+             */
+            void drop_unpacked() {
+                _unpacked.reset();
+            }
+
+            /**
+             *  Keeps the message compressed once for all peers which accept the codec, copies share it.
+             *  An empty compressed message means that the codec doesn't make this message smaller.
+             */
+            void set_compressed(uint32_t codec, fc::optional<message> compressed) {
+                _compressed_codec = codec;
+                _compressed = compressed ? std::make_shared<const message>(std::move(*compressed)) : nullptr;
+            }
+
+            /// codec the message was compressed with by set_compressed(), 0 if it wasn't
+            uint32_t compressed_codec() const {
+                return _compressed_codec;
+            }
+
+            const std::shared_ptr<const message> &compressed() const {
+                return _compressed;
+            }
+
             /**
              *  Automatically checks the type and deserializes T in the
              *  opposite process from the constructor.
@@ -86,6 +142,10 @@ namespace graphene {
             T as() const {
                 try {
                     FC_ASSERT(msg_type == T::type);
+                    if (_unpacked) {
+                        FC_ASSERT(_unpacked_type == T::type);
+                        return *static_cast<const T *>(_unpacked.get());
+                    }
                     T tmp;
                     if (data.size()) {
                         fc::datastream<const char *> ds(data.data(), data.size());
@@ -103,6 +163,14 @@ namespace graphene {
                                 ("msg_type", msg_type)
                 );
             }
+
+        private:
+            fc::optional<fc::uint160_t> _precomputed_id;
+            std::shared_ptr<const void> _unpacked;
+            /// type of the message which _unpacked holds
+            uint32_t _unpacked_type = 0;
+            std::shared_ptr<const message> _compressed;
+            uint32_t _compressed_codec = 0;
         };
 
 
@@ -74,6 +74,13 @@ namespace graphene {
 
             fc::sha512 get_shared_secret() const;
 
+            /**
+             *  Number of worker threads shared by all connections which decrypt, hash and unpack
+             *  large incoming messages.  With 0 threads everything is done in the connection's thread.
+             *  Connections pick their worker when they start reading.
+             */
+            static void set_read_worker_thread_count(uint32_t thread_count);
+
         private:
             std::unique_ptr<detail::message_oriented_connection_impl> my;
         };
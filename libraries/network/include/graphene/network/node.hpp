@@ -113,6 +113,33 @@ namespace graphene {
              */
             virtual message get_item(const item_id &id) = 0;
 
+            /**
+             *  Returns the packed block with the given id as the delegate stores it, so it can be sent
+             *  without unpacking and packing it again.  Returns an empty vector if the delegate can't
+             *  serve the block this way, get_item() is used then.
+             */
+            virtual std::vector<char> get_serialized_block(const item_hash_t &block_id) {
+                return std::vector<char>();
+            }
+
+            /**
+             *  Returns the header of a block which get_serialized_block() can serve, without reading
+             *  the whole block.  Returns nothing if the delegate can't serve the block this way.
+             */
+            virtual fc::optional<graphene::protocol::signed_block_header> get_block_header(const item_hash_t &block_id) {
+                return fc::optional<graphene::protocol::signed_block_header>();
+            }
+
+            /**
+             *  Returns up to count packed blocks starting from first_block_num, without unpacking them,
+             *  keeping their total size below max_total_size.  May return fewer blocks than asked
+             *  (or none) if the delegate can't serve them this way.
+             */
+            virtual std::vector<std::vector<char>> get_serialized_block_range(uint32_t first_block_num, uint32_t count,
+                    uint32_t max_total_size) {
+                return std::vector<std::vector<char>>();
+            }
+
             /**
              * Returns a synopsis of the blockchain used for syncing.
              * This consists of a list of selected item hashes from our current preferred
@@ -28,6 +28,7 @@
 #include <graphene/network/message_oriented_connection.hpp>
 #include <graphene/network/stcp_socket.hpp>
 #include <graphene/network/config.hpp>
+#include <graphene/network/rolling_bloom_filter.hpp>
 
 #include <boost/tuple/tuple.hpp>
 
@@ -40,12 +41,23 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 
+#include <map>
 #include <queue>
 #include <boost/container/deque.hpp>
 #include <fc/thread/future.hpp>
 
 namespace graphene {
     namespace network {
+        /**
+         * Blocks and transactions, which are worth compressing for peers that accept it
+         */
+        bool is_compressible_message_type(uint32_t msg_type);
+
+        /**
+         * Returns nothing when the compressed message wouldn't be smaller than the original
+         */
+        fc::optional<message> compress_message(const message &original, message_compression_codec codec);
+
         struct firewall_check_state_data {
             node_id_t expected_node_id;
             fc::ip::endpoint endpoint_to_test;
@@ -60,6 +72,32 @@ namespace graphene {
             node_id_t requesting_peer;
         };
 
+        /**
+         * Traffic of one message type: what was sent and received, how long outgoing messages
+         * waited in the send queue and how long incoming ones took to handle
+         */
+        struct message_traffic_stats {
+            uint64_t messages_sent = 0;
+            uint64_t bytes_sent = 0;
+            uint64_t messages_received = 0;
+            uint64_t bytes_received = 0;
+            fc::microseconds queueing_delay;
+            fc::microseconds handling_time;
+
+            void record(bool outgoing, size_t bytes, const fc::microseconds &time) {
+                if (outgoing) {
+                    ++messages_sent;
+                    bytes_sent += bytes;
+                    queueing_delay += time;
+                } else {
+                    ++messages_received;
+                    bytes_received += bytes;
+                    handling_time += time;
+                }
+            }
+        };
+        typedef std::map<uint32_t, message_traffic_stats> message_traffic_stats_map;
+
         class peer_connection;
 
         class peer_connection_delegate {
@@ -70,6 +108,20 @@ namespace graphene {
             virtual void on_connection_closed(peer_connection *originating_peer) = 0;
 
             virtual message get_message_for_item(const item_id &item) = 0;
+
+            /**
+             * Called for every message compressed before sending to the peer or decompressed after
+             * receiving from it
+             */
+            virtual void on_message_compression(peer_connection *peer, bool outgoing,
+                    size_t original_size, size_t compressed_size) = 0;
+
+            /**
+             * Called for every message sent to or handled from the peer.  bytes is the size on the wire,
+             * time is the send queue delay of outgoing messages and the handling time of incoming ones
+             */
+            virtual void on_message_traffic(peer_connection *peer, bool outgoing, uint32_t msg_type,
+                    size_t bytes, const fc::microseconds &time) = 0;
         };
 
         class peer_connection;
@@ -239,6 +291,14 @@ namespace graphene {
             item_hash_t last_block_delegate_has_seen; /// the hash of the last block  this peer has told us about that the peer knows
             fc::time_point_sec last_block_time_delegate_has_seen;
             bool inhibit_fetching_sync_blocks;
+            bool supports_block_ranges; /// peer announced "block_ranges" in its hello, contiguous sync requests go as fetch_block_range_message
+            std::vector<item_hash_t> sync_item_range_requested_from_peer; /// ids of the blocks in our outstanding fetch_block_range_message, in order
+            uint32_t sync_window; /// how many sync blocks we request from this peer at a time, adapted to how fast it delivers them
+            fc::time_point sync_batch_request_time; /// when we requested the batch of sync blocks in sync_items_requested_from_peer
+            uint64_t sync_batch_bytes_received; /// bytes of the current batch received so far
+            bool sync_batch_first_item_received;
+            fc::microseconds sync_round_trip_time; /// smoothed time from a sync request to the first block of it
+            uint64_t sync_bytes_per_second; /// smoothed rate at which the peer delivers sync blocks, 0 until the first batch completes
             /// @}
 
             /// non-synchronization state data
@@ -265,8 +325,29 @@ namespace graphene {
             timestamped_items_set_type inventory_advertised_to_peer;
 
             item_to_time_map_type items_requested_from_peer;  /// items we've requested from this peer during normal operation.  fetch from another peer if this peer disconnects
+            rolling_bloom_filter transactions_known_by_peer; /// transactions the peer advertised to us, we advertised to it, or one of us sent to the other
             /// @}
 
+            /// compact block relay state
+            /// @{
+            bool supports_compact_blocks; /// peer announced "compact_blocks" in its hello, we answer its block requests with compact_block_message
+            struct compact_block_reconstruction {
+                signed_block block;
+                std::vector<uint32_t> missing_transaction_indexes;
+                bool all_transactions_requested = false;
+            };
+            /// compact blocks received from this peer, waiting for the transactions we had to ask for, keyed by block message hash
+            std::unordered_map<item_hash_t, compact_block_reconstruction> compact_blocks_being_reconstructed;
+            /// @}
+
+            /// message compression state
+            /// @{
+            message_compression_codec compression_codec; /// codec the peer accepts, no_compression unless it announced one we support
+            uint32_t compression_threshold; /// messages smaller than this are sent to the peer uncompressed, 0 disables compression
+            /// @}
+
+            message_traffic_stats_map traffic_by_message_type; /// what we exchanged with this peer, by original (uncompressed) message type
+
             // if they're flooding us with transactions, we set this to avoid fetching for a few seconds to let the
             // blockchain catch up
             fc::time_point transaction_fetching_inhibited_until;
@@ -345,6 +426,10 @@ namespace graphene {
         private:
             void send_queued_messages_task();
 
+            message compress_message_for_sending(const message &message_to_send);
+
+            void record_message_traffic(bool outgoing, uint32_t msg_type, size_t bytes, const fc::microseconds &time);
+
             void accept_connection_task();
 
             void connect_to_task(const fc::ip::endpoint &remote_endpoint);
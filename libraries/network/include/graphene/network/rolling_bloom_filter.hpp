@@ -0,0 +1,74 @@
+#pragma once
+
+#include <graphene/network/core_messages.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace graphene {
+    namespace network {
+
+        /**
+         *  Bloom filter of item hashes which forgets old items: it keeps two generations of bits
+         *  and drops the older one after items_per_generation insertions, so it remembers at
+         *  least the last items_per_generation items.  False positives are possible, false
+         *  negatives only for items older than that.
+         */
+        class rolling_bloom_filter {
+        public:
+            rolling_bloom_filter(uint32_t items_per_generation, uint32_t bits_per_item)
+                    : _items_per_generation(items_per_generation),
+                      _current(words_for(items_per_generation, bits_per_item), 0),
+                      _previous(_current.size(), 0) {
+            }
+
+            void insert(const item_hash_t &item_hash) {
+                if (_items_in_current_generation >= _items_per_generation) {
+                    _previous.swap(_current);
+                    std::fill(_current.begin(), _current.end(), 0);
+                    _items_in_current_generation = 0;
+                }
+                for (uint32_t i = 0; i < number_of_hashes; ++i) {
+                    uint64_t bit = bit_for(item_hash, i);
+                    _current[bit / 64] |= uint64_t(1) << (bit % 64);
+                }
+                ++_items_in_current_generation;
+            }
+
+            bool contains(const item_hash_t &item_hash) const {
+                return contains(_current, item_hash) || contains(_previous, item_hash);
+            }
+
+        private:
+            /// item hashes are already uniformly distributed, so their words are used as the hash functions
+            static const uint32_t number_of_hashes = sizeof(item_hash_t) / sizeof(uint32_t);
+
+            static size_t words_for(uint32_t items, uint32_t bits_per_item) {
+                return std::max<size_t>((size_t(items) * bits_per_item + 63) / 64, 1);
+            }
+
+            uint64_t bit_for(const item_hash_t &item_hash, uint32_t hash_number) const {
+                uint32_t word;
+                memcpy(&word, (const char *)item_hash.data() + hash_number * sizeof(word), sizeof(word));
+                return word % (_current.size() * 64);
+            }
+
+            bool contains(const std::vector<uint64_t> &bits, const item_hash_t &item_hash) const {
+                for (uint32_t i = 0; i < number_of_hashes; ++i) {
+                    uint64_t bit = bit_for(item_hash, i);
+                    if (!(bits[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            uint32_t _items_per_generation;
+            uint32_t _items_in_current_generation = 0;
+            std::vector<uint64_t> _current;
+            std::vector<uint64_t> _previous;
+        };
+
+    }
+} // graphene::network
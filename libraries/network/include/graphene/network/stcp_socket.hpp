@@ -27,6 +27,8 @@
 #include <fc/crypto/aes.hpp>
 #include <fc/crypto/elliptic.hpp>
 
+#include <memory>
+
 namespace graphene {
     namespace network {
 
@@ -62,6 +64,20 @@ namespace graphene {
 
             virtual void flush();
 
+            /**
+             *  Reads exactly len bytes (a multiple of 16) from the socket without decrypting them,
+             *  to let the caller decrypt them on another thread
+             */
+            void read_encrypted(char *buffer, size_t len);
+
+            /**
+             *  Decoder of the incoming stream, shared to let another thread decrypt the bytes returned
+             *  by read_encrypted().  Bytes must be decrypted in the order they were read.
+             */
+            const std::shared_ptr<fc::aes_decoder> &get_receive_decoder() const {
+                return _recv_aes;
+            }
+
             virtual void close();
 
             using istream::get;
@@ -83,7 +99,7 @@ namespace graphene {
             //uint32_t             _buf_len;
             fc::tcp_socket _sock;
             fc::aes_encoder _send_aes;
-            fc::aes_decoder _recv_aes;
+            std::shared_ptr<fc::aes_decoder> _recv_aes;
             std::shared_ptr<char> _read_buffer;
             std::shared_ptr<char> _write_buffer;
 #ifndef NDEBUG
@@ -29,6 +29,11 @@
 #include <graphene/network/message_oriented_connection.hpp>
 #include <graphene/network/stcp_socket.hpp>
 #include <graphene/network/config.hpp>
+#include <graphene/network/core_messages.hpp>
+
+#include <zlib.h>
+
+#include <mutex>
 
 #ifdef DEFAULT_LOGGER
 # undef DEFAULT_LOGGER
@@ -44,12 +49,105 @@
 namespace graphene {
     namespace network {
         namespace detail {
+            /**
+             *  Threads shared by all connections to decrypt, hash and unpack large incoming messages.
+             *  Each connection waits for its message before reading the next one, so messages
+             *  of a connection are still delivered in the order they were received.
+             */
+            class read_worker_pool {
+            public:
+                static read_worker_pool &instance() {
+                    static read_worker_pool pool;
+                    return pool;
+                }
+
+                void set_thread_count(uint32_t thread_count) {
+                    std::vector<std::shared_ptr<fc::thread>> new_threads;
+                    for (uint32_t i = 0; i < thread_count; ++i) {
+                        new_threads.emplace_back(std::make_shared<fc::thread>("p2p read worker"));
+                    }
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    // connections keep the threads they are using until they are done with them
+                    _threads.swap(new_threads);
+                    _next_thread = 0;
+                }
+
+                std::shared_ptr<fc::thread> next_thread() {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (_threads.empty()) {
+                        return std::shared_ptr<fc::thread>();
+                    }
+                    return _threads[_next_thread++ % _threads.size()];
+                }
+
+            private:
+                std::mutex _mutex;
+                std::vector<std::shared_ptr<fc::thread>> _threads;
+                size_t _next_thread = 0;
+            };
+
+            /**
+             *  Computes the message id and unpacks the messages which are unpacked by the node anyway,
+             *  so the p2p thread doesn't have to. Unpack errors are reported when the node unpacks it.
+             */
+            static void precompute_message(message &m) {
+                m.precompute_id();
+                try {
+                    switch (m.msg_type) {
+                        case block_message_type:
+                            m.precompute<block_message>();
+                            break;
+                        case trx_message_type:
+                            m.precompute<trx_message>();
+                            break;
+                        case block_range_message_type:
+                            m.precompute<block_range_message>();
+                            break;
+                        default:
+                            break;
+                    }
+                } catch (const fc::exception &) {
+                }
+            }
+
+            static message decompress_message(const compressed_message &compressed) {
+                FC_ASSERT(compressed.codec == zlib_compression,
+                        "unsupported compression codec ${codec}", ("codec", compressed.codec));
+                FC_ASSERT(compressed.original_msg_type != compressed_message_type, "nested compressed message");
+                FC_ASSERT(compressed.original_size <= MAX_MESSAGE_SIZE,
+                        "", ("original_size", compressed.original_size)("MAX_MESSAGE_SIZE", MAX_MESSAGE_SIZE));
+                message original;
+                original.msg_type = compressed.original_msg_type;
+                original.size = compressed.original_size;
+                original.data.resize(compressed.original_size);
+                uLongf original_size = compressed.original_size;
+                int result = uncompress((Bytef *)original.data.data(), &original_size,
+                        (const Bytef *)compressed.compressed_data.data(), compressed.compressed_data.size());
+                FC_ASSERT(result == Z_OK && original_size == compressed.original_size,
+                        "invalid compressed message", ("result", result)("size", original_size)
+                        ("original_size", compressed.original_size));
+                return original;
+            }
+
+            /**
+             *  Replaces a compressed message with the original one, which remembers the size it was received with
+             */
+            static void decompress_received_message(message &m) {
+                if (m.msg_type != compressed_message_type) {
+                    return;
+                }
+                const uint32_t compressed_size = m.size;
+                m = decompress_message(m.as<compressed_message>());
+                m.compressed_size = compressed_size;
+            }
+
             class message_oriented_connection_impl {
             private:
                 message_oriented_connection *_self;
                 message_oriented_connection_delegate *_delegate;
                 stcp_socket _sock;
                 fc::future<void> _read_loop_done;
+                std::shared_ptr<fc::thread> _read_worker;
                 uint64_t _bytes_received;
                 uint64_t _bytes_sent;
 
@@ -152,14 +250,18 @@ namespace graphene {
                 static_assert(BUFFER_SIZE >=
                               sizeof(message_header), "insufficient buffer");
 
+                // smaller messages are cheaper to decode here than to hand off
+                const size_t MIN_SIZE_TO_DECODE_ON_WORKER = 1024;
+
                 _connected_time = fc::time_point::now();
+                _read_worker = read_worker_pool::instance().next_thread();
 
                 fc::oexception exception_to_rethrow;
                 bool call_on_connection_closed = false;
 
                 try {
-                    message m;
                     while (true) {
+                        message m;
                         char buffer[BUFFER_SIZE];
                         _sock.read(buffer, BUFFER_SIZE);
                         _bytes_received += BUFFER_SIZE;
@@ -175,11 +277,32 @@ namespace graphene {
                         std::copy(
                                 buffer + sizeof(message_header),
                                 buffer + sizeof(buffer), m.data.begin());
-                        if (remaining_bytes_with_padding) {
-                            _sock.read(&m.data[LEFTOVER], remaining_bytes_with_padding);
+                        // compressed messages always go to the worker, they are inflated to large ones
+                        if (_read_worker && (remaining_bytes_with_padding >= MIN_SIZE_TO_DECODE_ON_WORKER ||
+                                             m.msg_type == compressed_message_type)) {
+                            // the task owns everything it touches, the connection may be destroyed meanwhile
+                            auto ciphertext = std::make_shared<std::vector<char>>(remaining_bytes_with_padding);
+                            _sock.read_encrypted(ciphertext->data(), ciphertext->size());
                             _bytes_received += remaining_bytes_with_padding;
+
+                            auto decoded = std::make_shared<message>(std::move(m));
+                            auto decoder = _sock.get_receive_decoder();
+                            _read_worker->async([decoded, ciphertext, decoder]() {
+                                decoder->decode(ciphertext->data(), ciphertext->size(), &decoded->data[LEFTOVER]);
+                                decoded->data.resize(decoded->size); // truncate off the padding bytes
+                                // errors of decompression are rethrown by wait() and close the connection
+                                decompress_received_message(*decoded);
+                                precompute_message(*decoded);
+                            }, "decode message").wait();
+                            m = std::move(*decoded);
+                        } else {
+                            if (remaining_bytes_with_padding) {
+                                _sock.read(&m.data[LEFTOVER], remaining_bytes_with_padding);
+                                _bytes_received += remaining_bytes_with_padding;
+                            }
+                            m.data.resize(m.size); // truncate off the padding bytes
+                            decompress_received_message(m);
                         }
-                        m.data.resize(m.size); // truncate off the padding bytes
 
                         _last_message_received_time = fc::time_point::now();
 
@@ -400,5 +523,9 @@ namespace graphene {
             return my->get_shared_secret();
         }
 
+        void message_oriented_connection::set_read_worker_thread_count(uint32_t thread_count) {
+            detail::read_worker_pool::instance().set_thread_count(thread_count);
+        }
+
     }
 } // end namespace graphene::network
@@ -28,6 +28,7 @@
 #include <list>
 #include <forward_list>
 #include <iostream>
+#include <numeric>
 #include <boost/tuple/tuple.hpp>
 #include <boost/circular_buffer.hpp>
 
@@ -170,6 +171,8 @@ namespace graphene {
 
                 message_propagation_data get_message_propagation_data(const fc::uint160_t &hash_of_message_contents_to_lookup) const;
 
+                fc::optional<message> find_transaction_by_short_id(uint64_t short_transaction_id) const;
+
                 size_t size() const {
                     return _message_cache.size();
                 }
@@ -188,8 +191,11 @@ namespace graphene {
                     const message_hash_type &hash_of_message_to_cache,
                     const message_propagation_data &propagation_data,
                     const fc::uint160_t &message_content_hash) {
+                // the cache serves packed bytes to peers, an unpacked block would double its memory
+                message packed_message(message_to_cache);
+                packed_message.drop_unpacked();
                 _message_cache.insert(message_info(hash_of_message_to_cache,
-                        message_to_cache,
+                        packed_message,
                         block_clock,
                         propagation_data,
                         message_content_hash));
@@ -216,6 +222,27 @@ namespace graphene {
                 FC_THROW_EXCEPTION(fc::key_not_found_exception, "Requested message not in cache");
             }
 
+            fc::optional<message> blockchain_tied_message_cache::find_transaction_by_short_id(uint64_t short_transaction_id) const {
+                // hashes are ordered bytewise, so all hashes starting with the short id are adjacent and
+                // the first of them is not less than the short id padded with zeroes
+                message_hash_type lowest_hash;
+                memcpy(lowest_hash.data(), &short_transaction_id, sizeof(short_transaction_id));
+
+                fc::optional<message> result;
+                const auto &hash_idx = _message_cache.get<message_hash_index>();
+                for (auto iter = hash_idx.lower_bound(lowest_hash);
+                     iter != hash_idx.end() && get_short_transaction_id(iter->message_hash) == short_transaction_id; ++iter) {
+                    if (iter->message_body.msg_type == trx_message_type) {
+                        if (result) {
+                            // ambiguous short id, let the caller fetch the transaction from the peer
+                            return fc::optional<message>();
+                        }
+                        result = iter->message_body;
+                    }
+                }
+                return result;
+            }
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
             // This specifies configuration info for the local node.  It's stored as JSON
@@ -251,6 +278,40 @@ namespace graphene {
     namespace network {
         namespace detail {
 
+            /**
+             * A packed block_message starts with the packed block, so its header can be read
+             * without unpacking the transactions
+             */
+            static graphene::protocol::signed_block_header get_block_message_header(const message &block_message_to_read) {
+                FC_ASSERT(block_message_to_read.msg_type == block_message_type);
+                return fc::raw::unpack<graphene::protocol::signed_block_header>(block_message_to_read.data);
+            }
+
+            static fc::variant_object message_traffic_stats_to_variant(const message_traffic_stats_map &traffic) {
+                fc::mutable_variant_object result;
+                for (const auto &type_and_stats : traffic) {
+                    uint32_t msg_type = type_and_stats.first;
+                    const message_traffic_stats &stats = type_and_stats.second;
+                    std::string type_name = std::to_string(msg_type);
+                    if (msg_type == trx_message_type || msg_type == block_message_type ||
+                        (msg_type > core_message_type_first && msg_type <= compressed_message_type)) {
+                        type_name = fc::reflector<core_message_type_enum>::to_string(core_message_type_enum(msg_type));
+                    }
+
+                    fc::mutable_variant_object type_stats;
+                    type_stats["messages_sent"] = stats.messages_sent;
+                    type_stats["bytes_sent"] = stats.bytes_sent;
+                    type_stats["messages_received"] = stats.messages_received;
+                    type_stats["bytes_received"] = stats.bytes_received;
+                    type_stats["average_queueing_delay_us"] = stats.messages_sent
+                            ? stats.queueing_delay.count() / int64_t(stats.messages_sent) : 0;
+                    type_stats["average_handling_time_us"] = stats.messages_received
+                            ? stats.handling_time.count() / int64_t(stats.messages_received) : 0;
+                    result[type_name] = type_stats;
+                }
+                return result;
+            }
+
             // when requesting items from peers, we want to prioritize any blocks before
             // transactions, but otherwise request items in the order we heard about them
             struct prioritized_item_id {
@@ -292,6 +353,9 @@ namespace graphene {
                                    (handle_transaction) \
                                    (get_block_ids) \
                                    (get_item) \
+                                   (get_serialized_block) \
+                                   (get_block_header) \
+                                   (get_serialized_block_range) \
                                    (get_blockchain_synopsis) \
                                    (sync_status) \
                                    (connection_count_changed) \
@@ -399,6 +463,13 @@ namespace graphene {
 
                 message get_item(const item_id &id) override;
 
+                std::vector<char> get_serialized_block(const item_hash_t &block_id) override;
+
+                fc::optional<graphene::protocol::signed_block_header> get_block_header(const item_hash_t &block_id) override;
+
+                std::vector<std::vector<char>> get_serialized_block_range(uint32_t first_block_num, uint32_t count,
+                        uint32_t max_total_size) override;
+
                 std::vector<item_hash_t> get_blockchain_synopsis(const item_hash_t &reference_point,
                         uint32_t number_of_blocks_after_reference_point) override;
 
@@ -595,6 +666,24 @@ namespace graphene {
                 std::list<fc::future<void>> _handle_message_calls_in_progress;
                 std::set<message_hash_type> _message_ids_currently_being_processed;
 
+                /// every peer asks for the same new block, so keep the compact form of the last one we served
+                fc::optional<compact_block_message> _most_recent_compact_block;
+
+                uint32_t _message_compression_threshold; /// messages we send smaller than this stay uncompressed, 0 disables compression
+
+                uint32_t _transaction_advertisement_interval_ms; /// how long new transactions are collected before advertising them
+                fc::promise<void>::ptr _advertise_inventory_batch_done; /// set to stop collecting transactions early, e.g. for a new block
+
+                struct message_compression_stats {
+                    uint64_t messages = 0;
+                    uint64_t original_bytes = 0;
+                    uint64_t compressed_bytes = 0;
+                };
+                message_compression_stats _compressed_messages_sent;
+                message_compression_stats _compressed_messages_received;
+
+                message_traffic_stats_map _traffic_by_message_type; /// totals over all peers we've ever been connected to
+
                 node_impl(const std::string &user_agent);
 
                 virtual ~node_impl();
@@ -611,6 +700,10 @@ namespace graphene {
 
                 void request_sync_items_from_peer(const peer_connection_ptr &peer, const std::vector<item_hash_t> &items_to_request);
 
+                void start_sync_batch(peer_connection *peer);
+
+                void on_sync_item_received_from_peer(peer_connection *peer, size_t item_size);
+
                 void fetch_sync_items_loop();
 
                 void trigger_fetch_sync_items_loop();
@@ -715,6 +808,27 @@ namespace graphene {
                 void on_get_current_connections_reply_message(peer_connection *originating_peer,
                         const get_current_connections_reply_message &get_current_connections_reply_message_received);
 
+                compact_block_message get_compact_block_message(const message_hash_type &message_hash, const message &full_block_message);
+
+                fc::optional<message> get_serialized_block_message(const item_hash_t &block_id);
+
+                void on_compact_block_message(peer_connection *originating_peer,
+                        const compact_block_message &compact_block_message_received);
+
+                void on_get_compact_block_transactions_message(peer_connection *originating_peer,
+                        const get_compact_block_transactions_message &get_compact_block_transactions_message_received);
+
+                void on_compact_block_transactions_message(peer_connection *originating_peer,
+                        const compact_block_transactions_message &compact_block_transactions_message_received);
+
+                void process_reconstructed_compact_block(peer_connection *originating_peer, const message_hash_type &message_hash);
+
+                void on_fetch_block_range_message(peer_connection *originating_peer,
+                        const fetch_block_range_message &fetch_block_range_message_received);
+
+                void on_block_range_message(peer_connection *originating_peer,
+                        const block_range_message &block_range_message_received);
+
                 void on_connection_closed(peer_connection *originating_peer) override;
 
                 void send_sync_block_to_node_delegate(const graphene::network::block_message &block_message_to_send);
@@ -827,6 +941,12 @@ namespace graphene {
 
                 message get_message_for_item(const item_id &item) override;
 
+                void on_message_compression(peer_connection *peer, bool outgoing,
+                        size_t original_size, size_t compressed_size) override;
+
+                void on_message_traffic(peer_connection *peer, bool outgoing, uint32_t msg_type,
+                        size_t bytes, const fc::microseconds &time) override;
+
                 fc::variant_object network_get_info() const;
 
                 fc::variant_object network_get_usage_stats() const;
@@ -899,7 +1019,9 @@ namespace graphene {
                     _node_is_shutting_down(false),
                     _maximum_number_of_blocks_to_handle_at_one_time(MAXIMUM_NUMBER_OF_BLOCKS_TO_HANDLE_AT_ONE_TIME),
                     _maximum_number_of_sync_blocks_to_prefetch(MAXIMUM_NUMBER_OF_BLOCKS_TO_PREFETCH),
-                    _maximum_blocks_per_peer_during_syncing(GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING) {
+                    _maximum_blocks_per_peer_during_syncing(GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING),
+                    _message_compression_threshold(GRAPHENE_NET_DEFAULT_MESSAGE_COMPRESSION_THRESHOLD),
+                    _transaction_advertisement_interval_ms(GRAPHENE_NET_DEFAULT_TRANSACTION_ADVERTISEMENT_INTERVAL_MS) {
                 _rate_limiter.set_actual_rate_time_constant(fc::seconds(2));
                 fc::rand_pseudo_bytes(&_node_id.data[0], (int)_node_id.size());
             }
@@ -1070,6 +1192,9 @@ namespace graphene {
                 VERIFY_CORRECT_THREAD();
                 dlog("requesting item ${item_hash} from peer ${endpoint}", ("item_hash", item_to_request)("endpoint", peer->get_remote_endpoint()));
                 item_id item_id_to_request(graphene::network::block_message_type, item_to_request);
+                if (peer->sync_items_requested_from_peer.empty()) {
+                    start_sync_batch(peer.get());
+                }
                 _active_sync_requests.insert(active_sync_requests_map::value_type(item_to_request, fc::time_point::now()));
                 peer->last_sync_item_received_time = fc::time_point::now();
                 peer->sync_items_requested_from_peer.insert(item_to_request);
@@ -1082,14 +1207,74 @@ namespace graphene {
                 VERIFY_CORRECT_THREAD();
                 dlog("requesting ${item_count} item(s) ${items_to_request} from peer ${endpoint}",
                         ("item_count", items_to_request.size())("items_to_request", items_to_request)("endpoint", peer->get_remote_endpoint()));
+                if (peer->sync_items_requested_from_peer.empty()) {
+                    start_sync_batch(peer.get());
+                }
                 for (const item_hash_t &item_to_request : items_to_request) {
                     _active_sync_requests.insert(active_sync_requests_map::value_type(item_to_request, fc::time_point::now()));
                     peer->last_sync_item_received_time = fc::time_point::now();
                     peer->sync_items_requested_from_peer.insert(item_to_request);
                 }
+
+                // a run of consecutive blocks can be served straight from the peer's block log
+                if (peer->supports_block_ranges && items_to_request.size() > 1 &&
+                    peer->sync_item_range_requested_from_peer.empty()) {
+                    uint32_t first_block_num = _delegate->get_block_number(items_to_request.front());
+                    bool is_contiguous = true;
+                    for (size_t i = 1; i < items_to_request.size() && is_contiguous; ++i) {
+                        is_contiguous = _delegate->get_block_number(items_to_request[i]) == first_block_num + i;
+                    }
+                    if (is_contiguous) {
+                        peer->sync_item_range_requested_from_peer = items_to_request;
+                        peer->send_message(fetch_block_range_message(first_block_num, (uint32_t)items_to_request.size()));
+                        return;
+                    }
+                }
                 peer->send_message(fetch_items_message(graphene::network::block_message_type, items_to_request));
             }
 
+            void node_impl::start_sync_batch(peer_connection *peer) {
+                VERIFY_CORRECT_THREAD();
+                peer->sync_batch_request_time = fc::time_point::now();
+                peer->sync_batch_bytes_received = 0;
+                peer->sync_batch_first_item_received = false;
+            }
+
+            void node_impl::on_sync_item_received_from_peer(peer_connection *peer, size_t item_size) {
+                VERIFY_CORRECT_THREAD();
+                fc::time_point now = fc::time_point::now();
+                fc::microseconds elapsed = now - peer->sync_batch_request_time;
+                peer->sync_batch_bytes_received += item_size;
+
+                if (!peer->sync_batch_first_item_received) {
+                    peer->sync_batch_first_item_received = true;
+                    peer->sync_round_trip_time = peer->sync_round_trip_time.count()
+                                                 ? fc::microseconds((peer->sync_round_trip_time.count() * 7 + elapsed.count()) / 8)
+                                                 : elapsed;
+                }
+
+                if (!peer->sync_items_requested_from_peer.empty()) {
+                    return;
+                }
+
+                // the whole batch arrived, adapt the window like TCP adapts its congestion window
+                uint64_t bytes_per_second = peer->sync_batch_bytes_received * 1000000 / std::max<int64_t>(elapsed.count(), 1);
+                peer->sync_bytes_per_second = peer->sync_bytes_per_second
+                                              ? (peer->sync_bytes_per_second * 3 + bytes_per_second) / 4
+                                              : bytes_per_second;
+
+                const fc::microseconds target_duration = fc::milliseconds(GRAPHENE_NET_SYNC_BATCH_TARGET_DURATION_MS);
+                if (elapsed <= target_duration) {
+                    peer->sync_window = std::min<uint32_t>(peer->sync_window + peer->sync_window / 2 + 1,
+                            _maximum_blocks_per_peer_during_syncing);
+                } else if (elapsed > target_duration + target_duration) {
+                    peer->sync_window = std::max<uint32_t>(peer->sync_window / 2, GRAPHENE_NET_MIN_SYNC_WINDOW);
+                }
+                dlog("peer ${endpoint} delivered a batch of sync blocks in ${ms} ms at ${rate} B/s, window is now ${window}",
+                        ("endpoint", peer->get_remote_endpoint())("ms", elapsed.count() / 1000)
+                                ("rate", peer->sync_bytes_per_second)("window", peer->sync_window));
+            }
+
             void node_impl::fetch_sync_items_loop() {
                 VERIFY_CORRECT_THREAD();
                 while (!_fetch_sync_items_loop_done.canceled()) {
@@ -1103,8 +1288,31 @@ namespace graphene {
                             ASSERT_TASK_NOT_PREEMPTED();
                             std::set<item_hash_t> sync_items_to_request;
 
+                            // blocks are applied in order, so the fastest peers get the blocks we need first,
+                            // peers we haven't measured yet rank as the median measured peer, ahead of slow ones
+                            std::vector<peer_connection_ptr> peers_by_speed(_active_connections.begin(), _active_connections.end());
+                            std::vector<uint64_t> measured_rates;
+                            for (const peer_connection_ptr &peer : peers_by_speed) {
+                                if (peer->sync_bytes_per_second != 0) {
+                                    measured_rates.push_back(peer->sync_bytes_per_second);
+                                }
+                            }
+                            uint64_t median_rate = 0;
+                            if (!measured_rates.empty()) {
+                                auto median = measured_rates.begin() + measured_rates.size() / 2;
+                                std::nth_element(measured_rates.begin(), median, measured_rates.end());
+                                median_rate = *median;
+                            }
+                            auto ranked_rate = [median_rate](const peer_connection_ptr &peer) -> uint64_t {
+                                return peer->sync_bytes_per_second != 0 ? peer->sync_bytes_per_second : median_rate;
+                            };
+                            std::stable_sort(peers_by_speed.begin(), peers_by_speed.end(),
+                                    [&](const peer_connection_ptr &a, const peer_connection_ptr &b) {
+                                        return ranked_rate(a) > ranked_rate(b);
+                                    });
+
                             // for each idle peer that we're syncing with
-                            for (const peer_connection_ptr &peer : _active_connections) {
+                            for (const peer_connection_ptr &peer : peers_by_speed) {
                                 if (peer->we_need_sync_items_from_peer &&
                                     sync_item_requests_to_send.find(peer) ==
                                     sync_item_requests_to_send.end() &&
@@ -1128,7 +1336,7 @@ namespace graphene {
                                                 sync_item_requests_to_send[peer].push_back(item_to_potentially_request);
                                                 sync_items_to_request.insert(item_to_potentially_request);
                                                 if (sync_item_requests_to_send[peer].size() >=
-                                                    _maximum_blocks_per_peer_during_syncing) {
+                                                    std::min(peer->sync_window, _maximum_blocks_per_peer_during_syncing)) {
                                                         break;
                                                 }
                                             }
@@ -1326,6 +1534,20 @@ namespace graphene {
             void node_impl::advertise_inventory_loop() {
                 VERIFY_CORRECT_THREAD();
                 while (!_advertise_inventory_loop_done.canceled()) {
+                    // let new transactions pile up for a moment: each peer gets them in one message, and peers
+                    // which get them elsewhere meanwhile advertise them to us, so we don't advertise them back
+                    bool new_inventory_has_blocks = std::any_of(_new_inventory.begin(), _new_inventory.end(),
+                            [](const item_id &item) { return item.item_type == block_message_type; });
+                    if (_transaction_advertisement_interval_ms && !new_inventory_has_blocks) {
+                        _advertise_inventory_batch_done = fc::promise<void>::ptr(new fc::promise<void>("graphene::network::advertise_inventory_batch"));
+                        try {
+                            _advertise_inventory_batch_done->wait(fc::milliseconds(_transaction_advertisement_interval_ms));
+                        }
+                        catch (const fc::timeout_exception &) {
+                        }
+                        _advertise_inventory_batch_done.reset();
+                    }
+
                     dlog("beginning an iteration of advertise inventory");
                     // swap inventory into local variable, clearing the node's copy
                     std::unordered_set<item_id> inventory_to_advertise;
@@ -1352,10 +1574,15 @@ namespace graphene {
                                 //if (peer->inventory_peer_advertised_to_us.find(item_to_advertise) != peer->inventory_peer_advertised_to_us.end() )
                                 //   wdump((*peer->inventory_peer_advertised_to_us.find(item_to_advertise)));
 
+                                bool is_transaction = item_to_advertise.item_type == trx_message_type;
                                 if (peer->inventory_advertised_to_peer.find(item_to_advertise) ==
                                     peer->inventory_advertised_to_peer.end() &&
                                     peer->inventory_peer_advertised_to_us.find(item_to_advertise) ==
-                                    peer->inventory_peer_advertised_to_us.end()) {
+                                    peer->inventory_peer_advertised_to_us.end() &&
+                                    !(is_transaction && peer->transactions_known_by_peer.contains(item_to_advertise.item_hash))) {
+                                    if (is_transaction) {
+                                        peer->transactions_known_by_peer.insert(item_to_advertise.item_hash);
+                                    }
                                     items_to_advertise_by_type[item_to_advertise.item_type].push_back(item_to_advertise.item_hash);
                                     peer->inventory_advertised_to_peer.insert(peer_connection::timestamped_item_id(item_to_advertise, fc::time_point::now()));
                                     ++total_items_to_send_to_this_peer;
@@ -1943,6 +2170,21 @@ namespace graphene {
                     case core_message_type_enum::get_current_connections_reply_message_type:
                         on_get_current_connections_reply_message(originating_peer, received_message.as<get_current_connections_reply_message>());
                         break;
+                    case core_message_type_enum::compact_block_message_type:
+                        on_compact_block_message(originating_peer, received_message.as<compact_block_message>());
+                        break;
+                    case core_message_type_enum::get_compact_block_transactions_message_type:
+                        on_get_compact_block_transactions_message(originating_peer, received_message.as<get_compact_block_transactions_message>());
+                        break;
+                    case core_message_type_enum::compact_block_transactions_message_type:
+                        on_compact_block_transactions_message(originating_peer, received_message.as<compact_block_transactions_message>());
+                        break;
+                    case core_message_type_enum::fetch_block_range_message_type:
+                        on_fetch_block_range_message(originating_peer, received_message.as<fetch_block_range_message>());
+                        break;
+                    case core_message_type_enum::block_range_message_type:
+                        on_block_range_message(originating_peer, received_message.as<block_range_message>());
+                        break;
 
                     default:
                         // ignore any message in between core_message_type_first and _last that we don't handle above
@@ -1991,6 +2233,11 @@ namespace graphene {
 
                 user_data["chain_id"] = CHAIN_ID;
 
+                user_data["compact_blocks"] = true;
+                user_data["block_ranges"] = true;
+                // codecs we can decompress, what we send is decided by what the peer announces
+                user_data["compression"] = std::vector<std::string>{"zlib"};
+
                 return user_data;
             }
 
@@ -2024,6 +2271,20 @@ namespace graphene {
                 if (user_data.contains("chain_id")) {
                     originating_peer->chain_id = user_data["chain_id"].as<graphene::protocol::chain_id_type>();
                 }
+                if (user_data.contains("compact_blocks")) {
+                    originating_peer->supports_compact_blocks = user_data["compact_blocks"].as_bool();
+                }
+                if (user_data.contains("block_ranges")) {
+                    originating_peer->supports_block_ranges = user_data["block_ranges"].as_bool();
+                }
+                if (user_data.contains("compression")) {
+                    for (const std::string &codec : user_data["compression"].as<std::vector<std::string>>()) {
+                        if (codec == "zlib") {
+                            originating_peer->compression_codec = zlib_compression;
+                            originating_peer->compression_threshold = _message_compression_threshold;
+                        }
+                    }
+                }
             }
 
             void node_impl::on_hello_message(peer_connection *originating_peer, const hello_message &hello_message_received) {
@@ -2819,6 +3080,12 @@ namespace graphene {
                 }
                 catch (fc::key_not_found_exception &) {
                 }
+                if (item.item_type == block_message_type) {
+                    fc::optional<message> block_message_from_log = get_serialized_block_message(item.item_hash);
+                    if (block_message_from_log) {
+                        return std::move(*block_message_from_log);
+                    }
+                }
                 try {
                     return _delegate->get_item(item);
                 }
@@ -2827,6 +3094,47 @@ namespace graphene {
                 return item_not_available_message(item);
             }
 
+            fc::optional<message> node_impl::get_serialized_block_message(const item_hash_t &block_id) {
+                VERIFY_CORRECT_THREAD();
+                std::vector<char> packed_block;
+                try {
+                    packed_block = _delegate->get_serialized_block(block_id);
+                }
+                catch (const fc::canceled_exception &) {
+                    throw;
+                }
+                catch (const fc::exception &e) {
+                    wlog("Unable to read packed block ${id}, fetching it the usual way: ${e}", ("id", block_id)("e", e));
+                }
+                if (packed_block.empty()) {
+                    return fc::optional<message>();
+                }
+
+                // a packed block_message is the packed block followed by its id
+                std::vector<char> packed_block_id = fc::raw::pack(block_id);
+                message result;
+                result.msg_type = block_message_type;
+                result.data = std::move(packed_block);
+                result.data.insert(result.data.end(), packed_block_id.begin(), packed_block_id.end());
+                result.size = (uint32_t)result.data.size();
+                return result;
+            }
+
+            void node_impl::on_message_compression(peer_connection *peer, bool outgoing,
+                    size_t original_size, size_t compressed_size) {
+                VERIFY_CORRECT_THREAD();
+                message_compression_stats &stats = outgoing ? _compressed_messages_sent : _compressed_messages_received;
+                ++stats.messages;
+                stats.original_bytes += original_size;
+                stats.compressed_bytes += compressed_size;
+            }
+
+            void node_impl::on_message_traffic(peer_connection *peer, bool outgoing, uint32_t msg_type,
+                    size_t bytes, const fc::microseconds &time) {
+                VERIFY_CORRECT_THREAD();
+                _traffic_by_message_type[msg_type].record(outgoing, bytes, time);
+            }
+
             void node_impl::on_fetch_items_message(peer_connection *originating_peer, const fetch_items_message &fetch_items_message_received) {
                 VERIFY_CORRECT_THREAD();
                 dlog("received items request for ids ${ids} of type ${type} from peer ${endpoint}",
@@ -2834,20 +3142,27 @@ namespace graphene {
                                 ("type", fetch_items_message_received.item_type)
                                 ("endpoint", originating_peer->get_remote_endpoint()));
 
-                fc::optional<message> last_block_message_sent;
+                fc::optional<graphene::protocol::signed_block_header> last_block_header_sent;
 
-                std::list<message> reply_messages;
+                // block replies are queued by id and read when they are sent, so blocks which the delegate
+                // can serve packed have no message here, only their header is read to update the peer
+                std::list<std::pair<item_hash_t, fc::optional<message>>> reply_messages;
                 for (const item_hash_t &item_hash : fetch_items_message_received.items_to_fetch) {
                     try {
                         message requested_message = _message_cache.get_message(item_hash);
                         dlog("received item request for item ${id} from peer ${endpoint}, returning the item from my message cache",
                                 ("endpoint", originating_peer->get_remote_endpoint())
                                         ("id", requested_message.id()));
-                        reply_messages.push_back(requested_message);
                         if (fetch_items_message_received.item_type ==
                             block_message_type) {
-                                last_block_message_sent = requested_message;
+                                last_block_header_sent = get_block_message_header(requested_message);
+                                // a freshly relayed block, the peer most likely has its transactions already
+                                if (originating_peer->supports_compact_blocks) {
+                                    reply_messages.emplace_back(item_hash, get_compact_block_message(item_hash, requested_message));
+                                    continue;
+                                }
                         }
+                        reply_messages.emplace_back(item_hash, requested_message);
                         continue;
                     }
                     catch (fc::key_not_found_exception &) {
@@ -2855,38 +3170,59 @@ namespace graphene {
                     }
 
                     item_id item_to_fetch(fetch_items_message_received.item_type, item_hash);
+                    if (fetch_items_message_received.item_type == block_message_type) {
+                        fc::optional<graphene::protocol::signed_block_header> header;
+                        try {
+                            header = _delegate->get_block_header(item_hash);
+                        }
+                        catch (const fc::canceled_exception &) {
+                            throw;
+                        }
+                        catch (const fc::exception &e) {
+                            wlog("Unable to read header of block ${id}, fetching it the usual way: ${e}", ("id", item_hash)("e", e));
+                        }
+                        if (header) {
+                            dlog("received item request from peer ${endpoint}, returning the packed block ${id} from delegate",
+                                    ("id", item_hash)("endpoint", originating_peer->get_remote_endpoint()));
+                            last_block_header_sent = std::move(header);
+                            reply_messages.emplace_back(item_hash, fc::optional<message>());
+                            continue;
+                        }
+                    }
                     try {
                         message requested_message = _delegate->get_item(item_to_fetch);
                         dlog("received item request from peer ${endpoint}, returning the item from delegate with id ${id} size ${size}",
                                 ("id", requested_message.id())
                                         ("size", requested_message.size)
                                         ("endpoint", originating_peer->get_remote_endpoint()));
-                        reply_messages.push_back(requested_message);
                         if (fetch_items_message_received.item_type ==
                             block_message_type) {
-                                last_block_message_sent = requested_message;
+                                last_block_header_sent = get_block_message_header(requested_message);
                         }
+                        reply_messages.emplace_back(item_hash, std::move(requested_message));
                         continue;
                     }
                     catch (fc::key_not_found_exception &) {
-                        reply_messages.push_back(item_not_available_message(item_to_fetch));
+                        reply_messages.emplace_back(item_hash, item_not_available_message(item_to_fetch));
                         dlog("received item request from peer ${endpoint} but we don't have it",
                                 ("endpoint", originating_peer->get_remote_endpoint()));
                     }
                 }
 
                 // if we sent them a block, update our record of the last block they've seen accordingly
-                if (last_block_message_sent) {
-                    graphene::network::block_message block = last_block_message_sent->as<graphene::network::block_message>();
-                    originating_peer->last_block_delegate_has_seen = block.block_id;
-                    originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(block.block_id);
+                if (last_block_header_sent) {
+                    originating_peer->last_block_delegate_has_seen = last_block_header_sent->id();
+                    originating_peer->last_block_time_delegate_has_seen = last_block_header_sent->timestamp;
                 }
 
-                for (const message &reply : reply_messages) {
-                    if (reply.msg_type == block_message_type) {
-                        originating_peer->send_item(item_id(block_message_type, reply.as<graphene::network::block_message>().block_id));
+                for (const auto &reply : reply_messages) {
+                    if (!reply.second || reply.second->msg_type == block_message_type) {
+                        originating_peer->send_item(item_id(block_message_type, reply.first));
                     } else {
-                        originating_peer->send_message(reply);
+                        if (reply.second->msg_type == trx_message_type) {
+                            originating_peer->transactions_known_by_peer.insert(reply.first);
+                        }
+                        originating_peer->send_message(*reply.second);
                     }
                 }
             }
@@ -2898,6 +3234,7 @@ namespace graphene {
                 if (regular_item_iter !=
                     originating_peer->items_requested_from_peer.end()) {
                     originating_peer->items_requested_from_peer.erase(regular_item_iter);
+                    originating_peer->compact_blocks_being_reconstructed.erase(requested_item.item_hash);
                     originating_peer->inventory_peer_advertised_to_us.erase(requested_item);
                     if (is_item_in_any_peers_inventory(requested_item)) {
                         _items_to_fetch.insert(prioritized_item_id(requested_item, _items_to_fetch_sequence_counter++));
@@ -2942,6 +3279,9 @@ namespace graphene {
                             continue;
                     }
                     item_id advertised_item_id(item_ids_inventory_message_received.item_type, item_hash);
+                    if (advertised_item_id.item_type == trx_message_type) {
+                        originating_peer->transactions_known_by_peer.insert(item_hash);
+                    }
 
                     if (_new_inventory.find(advertised_item_id) !=
                         _new_inventory.end()) {
@@ -3600,6 +3940,7 @@ namespace graphene {
                         originating_peer->sync_items_requested_from_peer.end()) {
                         originating_peer->sync_items_requested_from_peer.erase(sync_item_iter);
                         originating_peer->last_sync_item_received_time = fc::time_point::now();
+                        on_sync_item_received_from_peer(originating_peer, message_to_process.size);
                         _active_sync_requests.erase(block_message_to_process.block_id);
                         process_block_during_sync(originating_peer, block_message_to_process, message_hash);
                         if (originating_peer->idle()) {
@@ -3631,6 +3972,249 @@ namespace graphene {
                 disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
             }
 
+            compact_block_message node_impl::get_compact_block_message(const message_hash_type &message_hash, const message &full_block_message) {
+                VERIFY_CORRECT_THREAD();
+                if (!_most_recent_compact_block || _most_recent_compact_block->message_hash != message_hash) {
+                    graphene::network::block_message block_message_to_compact = full_block_message.as<graphene::network::block_message>();
+                    std::vector<uint64_t> short_transaction_ids;
+                    short_transaction_ids.reserve(block_message_to_compact.block.transactions.size());
+                    for (const signed_transaction &trx : block_message_to_compact.block.transactions) {
+                        short_transaction_ids.push_back(get_short_transaction_id(message(trx_message(trx)).id()));
+                    }
+                    _most_recent_compact_block = compact_block_message(message_hash, block_message_to_compact.block,
+                            std::move(short_transaction_ids));
+                }
+                return *_most_recent_compact_block;
+            }
+
+            void node_impl::on_compact_block_message(peer_connection *originating_peer,
+                    const compact_block_message &compact_block_message_received) {
+                VERIFY_CORRECT_THREAD();
+                const message_hash_type &message_hash = compact_block_message_received.message_hash;
+                if (originating_peer->items_requested_from_peer.find(item_id(graphene::network::block_message_type, message_hash)) ==
+                    originating_peer->items_requested_from_peer.end()) {
+                    wlog("received a compact block ${hash} I didn't ask for from peer ${endpoint}, disconnecting from peer",
+                            ("hash", message_hash)("endpoint", originating_peer->get_remote_endpoint()));
+                    fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me a compact block that I didn't ask for, message_hash: ${hash}",
+                            ("hash", message_hash)));
+                    disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
+                    return;
+                }
+
+                peer_connection::compact_block_reconstruction reconstruction;
+                static_cast<graphene::protocol::signed_block_header &>(reconstruction.block) = compact_block_message_received.header;
+
+                const std::vector<uint64_t> &short_ids = compact_block_message_received.short_transaction_ids;
+                reconstruction.block.transactions.resize(short_ids.size());
+                for (uint32_t i = 0; i < short_ids.size(); ++i) {
+                    fc::optional<message> cached_transaction = _message_cache.find_transaction_by_short_id(short_ids[i]);
+                    if (cached_transaction) {
+                        reconstruction.block.transactions[i] = cached_transaction->as<trx_message>().trx;
+                    } else {
+                        reconstruction.missing_transaction_indexes.push_back(i);
+                    }
+                }
+
+                dlog("received compact block ${hash} with ${count} transactions from peer ${endpoint}, ${missing} missing from our cache",
+                        ("hash", message_hash)("count", short_ids.size())
+                                ("endpoint", originating_peer->get_remote_endpoint())
+                                ("missing", reconstruction.missing_transaction_indexes.size()));
+
+                std::vector<uint32_t> transactions_to_request = reconstruction.missing_transaction_indexes;
+                originating_peer->compact_blocks_being_reconstructed[message_hash] = std::move(reconstruction);
+                if (transactions_to_request.empty()) {
+                    process_reconstructed_compact_block(originating_peer, message_hash);
+                } else {
+                    originating_peer->send_message(get_compact_block_transactions_message(message_hash, transactions_to_request));
+                }
+            }
+
+            void node_impl::on_get_compact_block_transactions_message(peer_connection *originating_peer,
+                    const get_compact_block_transactions_message &get_compact_block_transactions_message_received) {
+                VERIFY_CORRECT_THREAD();
+                const message_hash_type &message_hash = get_compact_block_transactions_message_received.message_hash;
+                item_id requested_block(graphene::network::block_message_type, message_hash);
+                try {
+                    graphene::network::block_message requested_block_message =
+                            _message_cache.get_message(message_hash).as<graphene::network::block_message>();
+                    const std::vector<signed_transaction> &transactions = requested_block_message.block.transactions;
+
+                    compact_block_transactions_message reply;
+                    reply.message_hash = message_hash;
+                    reply.transactions.reserve(get_compact_block_transactions_message_received.transaction_indexes.size());
+                    for (uint32_t index : get_compact_block_transactions_message_received.transaction_indexes) {
+                        FC_ASSERT(index < transactions.size(), "Transaction index ${index} is out of block range", ("index", index));
+                        reply.transactions.push_back(transactions[index]);
+                    }
+                    originating_peer->send_message(reply);
+                }
+                catch (const fc::key_not_found_exception &) {
+                    dlog("peer ${endpoint} asked for transactions of compact block ${hash} which is no longer in our cache",
+                            ("endpoint", originating_peer->get_remote_endpoint())("hash", message_hash));
+                    originating_peer->send_message(item_not_available_message(requested_block));
+                }
+                catch (const fc::assert_exception &e) {
+                    disconnect_from_peer(originating_peer, "You asked for compact block transactions that do not exist", true, e);
+                }
+            }
+
+            void node_impl::on_compact_block_transactions_message(peer_connection *originating_peer,
+                    const compact_block_transactions_message &compact_block_transactions_message_received) {
+                VERIFY_CORRECT_THREAD();
+                const message_hash_type &message_hash = compact_block_transactions_message_received.message_hash;
+                auto reconstruction_iter = originating_peer->compact_blocks_being_reconstructed.find(message_hash);
+                if (reconstruction_iter == originating_peer->compact_blocks_being_reconstructed.end()) {
+                    dlog("received transactions for compact block ${hash} we are not reconstructing, ignoring them",
+                            ("hash", message_hash));
+                    return;
+                }
+
+                peer_connection::compact_block_reconstruction &reconstruction = reconstruction_iter->second;
+                const std::vector<signed_transaction> &transactions = compact_block_transactions_message_received.transactions;
+                if (transactions.size() != reconstruction.missing_transaction_indexes.size()) {
+                    // the error is built before the erase, which destroys the reconstruction
+                    fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me ${count} transactions for compact block ${hash}, but I asked for ${expected}",
+                            ("count", transactions.size())("hash", message_hash)
+                                    ("expected", reconstruction.missing_transaction_indexes.size())));
+                    originating_peer->compact_blocks_being_reconstructed.erase(reconstruction_iter);
+                    disconnect_from_peer(originating_peer, "You sent me the wrong compact block transactions", true, detailed_error);
+                    return;
+                }
+
+                for (size_t i = 0; i < transactions.size(); ++i) {
+                    reconstruction.block.transactions[reconstruction.missing_transaction_indexes[i]] = transactions[i];
+                }
+                reconstruction.missing_transaction_indexes.clear();
+                process_reconstructed_compact_block(originating_peer, message_hash);
+            }
+
+            void node_impl::process_reconstructed_compact_block(peer_connection *originating_peer, const message_hash_type &message_hash) {
+                VERIFY_CORRECT_THREAD();
+                auto reconstruction_iter = originating_peer->compact_blocks_being_reconstructed.find(message_hash);
+                assert(reconstruction_iter != originating_peer->compact_blocks_being_reconstructed.end());
+
+                graphene::network::block_message block_message_to_process(reconstruction_iter->second.block);
+                if (message(block_message_to_process).id() != message_hash) {
+                    // either a short id collision picked the wrong transaction from our cache, or the peer is lying
+                    peer_connection::compact_block_reconstruction &reconstruction = reconstruction_iter->second;
+                    if (!reconstruction.all_transactions_requested) {
+                        wlog("compact block ${hash} from peer ${endpoint} doesn't match its hash after reconstruction, requesting all of its transactions",
+                                ("hash", message_hash)("endpoint", originating_peer->get_remote_endpoint()));
+                        reconstruction.all_transactions_requested = true;
+                        reconstruction.missing_transaction_indexes.resize(reconstruction.block.transactions.size());
+                        std::iota(reconstruction.missing_transaction_indexes.begin(), reconstruction.missing_transaction_indexes.end(), 0);
+                        originating_peer->send_message(get_compact_block_transactions_message(message_hash, reconstruction.missing_transaction_indexes));
+                        return;
+                    }
+                    originating_peer->compact_blocks_being_reconstructed.erase(reconstruction_iter);
+                    fc::exception detailed_error(FC_LOG_MESSAGE(error, "Compact block doesn't match its hash, message_hash: ${hash}",
+                            ("hash", message_hash)));
+                    disconnect_from_peer(originating_peer, "You sent me a compact block that doesn't match the block you advertised", true, detailed_error);
+                    return;
+                }
+                originating_peer->compact_blocks_being_reconstructed.erase(reconstruction_iter);
+
+                // from here on it is exactly the block we asked for, handle it as if it came in a block_message
+                auto item_iter = originating_peer->items_requested_from_peer.find(item_id(graphene::network::block_message_type, message_hash));
+                if (item_iter != originating_peer->items_requested_from_peer.end()) {
+                    originating_peer->items_requested_from_peer.erase(item_iter);
+                }
+                process_block_during_normal_operation(originating_peer, block_message_to_process, message_hash);
+                if (originating_peer->idle()) {
+                    trigger_fetch_items_loop();
+                }
+            }
+
+            void node_impl::on_fetch_block_range_message(peer_connection *originating_peer,
+                    const fetch_block_range_message &fetch_block_range_message_received) {
+                VERIFY_CORRECT_THREAD();
+                uint32_t first_block_num = fetch_block_range_message_received.first_block_num;
+                uint32_t block_count = std::min<uint32_t>(fetch_block_range_message_received.block_count,
+                        GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING);
+                dlog("received request for ${count} blocks starting from #${first} from peer ${endpoint}",
+                        ("count", block_count)("first", first_block_num)("endpoint", originating_peer->get_remote_endpoint()));
+
+                std::vector<std::vector<char>> packed_blocks;
+                try {
+                    packed_blocks = _delegate->get_serialized_block_range(first_block_num, block_count,
+                            GRAPHENE_NET_MAX_BLOCK_RANGE_SIZE_IN_BYTES);
+                }
+                catch (const fc::canceled_exception &) {
+                    throw;
+                }
+                catch (const fc::exception &e) {
+                    // the peer will fetch the blocks one by one
+                    wlog("Unable to read block range for peer ${endpoint}: ${e}",
+                            ("endpoint", originating_peer->get_remote_endpoint())("e", e));
+                }
+
+                // only the header is unpacked, to remember the last block the peer has seen
+                if (!packed_blocks.empty()) {
+                    graphene::protocol::signed_block_header last_header =
+                            fc::raw::unpack<graphene::protocol::signed_block_header>(packed_blocks.back());
+                    originating_peer->last_block_delegate_has_seen = last_header.id();
+                    originating_peer->last_block_time_delegate_has_seen = last_header.timestamp;
+                }
+                originating_peer->send_message(block_range_message(first_block_num, std::move(packed_blocks)));
+            }
+
+            void node_impl::on_block_range_message(peer_connection *originating_peer,
+                    const block_range_message &block_range_message_received) {
+                VERIFY_CORRECT_THREAD();
+                std::vector<item_hash_t> requested_items;
+                requested_items.swap(originating_peer->sync_item_range_requested_from_peer);
+                if (requested_items.empty() ||
+                    _delegate->get_block_number(requested_items.front()) != block_range_message_received.first_block_num ||
+                    block_range_message_received.packed_blocks.size() > requested_items.size()) {
+                    wlog("received a block range starting from #${first} I didn't ask for from peer ${endpoint}, disconnecting from peer",
+                            ("first", block_range_message_received.first_block_num)("endpoint", originating_peer->get_remote_endpoint()));
+                    fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me a block range that I didn't ask for, first block: ${first}",
+                            ("first", block_range_message_received.first_block_num)));
+                    disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
+                    return;
+                }
+
+                dlog("received ${count} of ${requested} sync blocks in a block range from peer ${endpoint}",
+                        ("count", block_range_message_received.packed_blocks.size())("requested", requested_items.size())
+                                ("endpoint", originating_peer->get_remote_endpoint()));
+
+                size_t blocks_received = 0;
+                for (const std::vector<char> &packed_block : block_range_message_received.packed_blocks) {
+                    graphene::network::block_message block_message_to_process(fc::raw::unpack<signed_block>(packed_block));
+                    if (block_message_to_process.block_id != requested_items[blocks_received]) {
+                        wlog("received block ${block_id} in a block range from peer ${endpoint}, but expected ${expected}, disconnecting from peer",
+                                ("block_id", block_message_to_process.block_id)("expected", requested_items[blocks_received])
+                                        ("endpoint", originating_peer->get_remote_endpoint()));
+                        fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me a block that I didn't ask for, block_id: ${block_id}",
+                                ("block_id", block_message_to_process.block_id)));
+                        disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
+                        return;
+                    }
+                    ++blocks_received;
+
+                    originating_peer->sync_items_requested_from_peer.erase(block_message_to_process.block_id);
+                    originating_peer->last_sync_item_received_time = fc::time_point::now();
+                    on_sync_item_received_from_peer(originating_peer, packed_block.size());
+                    _active_sync_requests.erase(block_message_to_process.block_id);
+                    process_block_during_sync(originating_peer, block_message_to_process, message_hash_type());
+                }
+
+                if (blocks_received < requested_items.size()) {
+                    // the rest isn't in the peer's block log (yet), ask for it the usual way
+                    std::vector<item_hash_t> remaining_items(requested_items.begin() + blocks_received, requested_items.end());
+                    dlog("requesting ${count} remaining block(s) of the range from peer ${endpoint} by id",
+                            ("count", remaining_items.size())("endpoint", originating_peer->get_remote_endpoint()));
+                    originating_peer->send_message(fetch_items_message(graphene::network::block_message_type, remaining_items));
+                } else if (originating_peer->idle()) {
+                    if (originating_peer->number_of_unfetched_item_ids > 0 &&
+                        originating_peer->ids_of_items_to_get.size() < GRAPHENE_NET_MIN_BLOCK_IDS_TO_PREFETCH) {
+                        fetch_next_batch_of_item_ids_from_peer(originating_peer);
+                    } else {
+                        trigger_fetch_sync_items_loop();
+                    }
+                }
+            }
+
             void node_impl::on_current_time_request_message(peer_connection *originating_peer,
                     const current_time_request_message &current_time_request_message_received) {
                 VERIFY_CORRECT_THREAD();
@@ -3927,6 +4511,7 @@ namespace graphene {
                     fc::time_point message_validated_time;
                     try {
                         if (message_to_process.msg_type == trx_message_type) {
+                            originating_peer->transactions_known_by_peer.insert(message_hash);
                             trx_message transaction_message_to_process = message_to_process.as<trx_message>();
                             dlog("passing message containing transaction ${trx} to client", ("trx", transaction_message_to_process.trx.id()));
                             _delegate->handle_transaction(transaction_message_to_process);
@@ -4114,6 +4699,9 @@ namespace graphene {
                 try {
                     _advertise_inventory_loop_done.cancel("node_impl::close()");
                     // cancel() is currently broken, so we need to wake up the task to allow it to finish
+                    if (_advertise_inventory_batch_done) {
+                        _advertise_inventory_batch_done->set_value();
+                    }
                     trigger_advertise_inventory_loop();
                     _advertise_inventory_loop_done.wait();
                     dlog("Advertise inventory loop terminated");
@@ -4891,6 +5479,9 @@ namespace graphene {
                     peer_details["current_head_block"] = peer->last_block_delegate_has_seen;
                     peer_details["current_head_block_number"] = _delegate->get_block_number(peer->last_block_delegate_has_seen);
                     peer_details["current_head_block_time"] = peer->last_block_time_delegate_has_seen;
+                    peer_details["sync_window"] = peer->sync_window;
+                    peer_details["sync_round_trip_time_ms"] = peer->sync_round_trip_time.count() / 1000;
+                    peer_details["sync_bytes_per_second"] = peer->sync_bytes_per_second;
 
                     this_peer_status.info = peer_details;
                     statuses.push_back(this_peer_status);
@@ -4919,8 +5510,18 @@ namespace graphene {
                 }
                 message_hash_type hash_of_item_to_broadcast = item_to_broadcast.id();
 
-                _message_cache.cache_message(item_to_broadcast, hash_of_item_to_broadcast, propagation_data, hash_of_message_contents);
+                // compressed here once for all peers which accept compression, they take it from the cache
+                message message_to_cache(item_to_broadcast);
+                if (_message_compression_threshold && message_to_cache.size >= _message_compression_threshold &&
+                    is_compressible_message_type(message_to_cache.msg_type)) {
+                    message_to_cache.set_compressed(zlib_compression, compress_message(message_to_cache, zlib_compression));
+                }
+                _message_cache.cache_message(message_to_cache, hash_of_item_to_broadcast, propagation_data, hash_of_message_contents);
                 _new_inventory.insert(item_id(item_to_broadcast.msg_type, hash_of_item_to_broadcast));
+                // blocks don't wait for the batch of transactions
+                if (item_to_broadcast.msg_type == block_message_type && _advertise_inventory_batch_done) {
+                    _advertise_inventory_batch_done->set_value();
+                }
                 trigger_advertise_inventory_loop();
             }
 
@@ -4978,6 +5579,15 @@ namespace graphene {
                 if (params.contains("maximum_blocks_per_peer_during_syncing")) {
                     _maximum_blocks_per_peer_during_syncing = params["maximum_blocks_per_peer_during_syncing"].as<uint32_t>();
                 }
+                if (params.contains("transaction_advertisement_interval_ms")) {
+                    _transaction_advertisement_interval_ms = params["transaction_advertisement_interval_ms"].as<uint32_t>();
+                }
+                if (params.contains("message_compression_threshold")) {
+                    _message_compression_threshold = params["message_compression_threshold"].as<uint32_t>();
+                    for (const peer_connection_ptr &peer : _active_connections) {
+                        peer->compression_threshold = _message_compression_threshold;
+                    }
+                }
 
                 _desired_number_of_connections = std::min(_desired_number_of_connections, _maximum_number_of_connections);
 
@@ -4998,6 +5608,8 @@ namespace graphene {
                 result["maximum_number_of_blocks_to_handle_at_one_time"] = _maximum_number_of_blocks_to_handle_at_one_time;
                 result["maximum_number_of_sync_blocks_to_prefetch"] = _maximum_number_of_sync_blocks_to_prefetch;
                 result["maximum_blocks_per_peer_during_syncing"] = _maximum_blocks_per_peer_during_syncing;
+                result["message_compression_threshold"] = _message_compression_threshold;
+                result["transaction_advertisement_interval_ms"] = _transaction_advertisement_interval_ms;
                 return result;
             }
 
@@ -5094,6 +5706,38 @@ namespace graphene {
                 result["usage_by_second"] = network_usage_by_second;
                 result["usage_by_minute"] = network_usage_by_minute;
                 result["usage_by_hour"] = network_usage_by_hour;
+
+                auto compression_stats_to_variant = [](const message_compression_stats &stats) {
+                    fc::mutable_variant_object result;
+                    result["messages"] = stats.messages;
+                    result["original_bytes"] = stats.original_bytes;
+                    result["compressed_bytes"] = stats.compressed_bytes;
+                    return result;
+                };
+                uint32_t peers_accepting_compression = 0;
+                for (const peer_connection_ptr &peer : _active_connections) {
+                    if (peer->compression_codec != no_compression) {
+                        ++peers_accepting_compression;
+                    }
+                }
+                fc::mutable_variant_object compression;
+                compression["threshold"] = _message_compression_threshold;
+                compression["peers_accepting_compression"] = peers_accepting_compression;
+                compression["sent"] = compression_stats_to_variant(_compressed_messages_sent);
+                compression["received"] = compression_stats_to_variant(_compressed_messages_received);
+                result["compression"] = compression;
+
+                result["traffic_by_message_type"] = message_traffic_stats_to_variant(_traffic_by_message_type);
+                // peers are identified by node id, their addresses aren't shown as the api can be public
+                std::vector<fc::variant_object> traffic_by_peer;
+                traffic_by_peer.reserve(_active_connections.size());
+                for (const peer_connection_ptr &peer : _active_connections) {
+                    fc::mutable_variant_object peer_traffic;
+                    peer_traffic["node_id"] = peer->node_id;
+                    peer_traffic["traffic_by_message_type"] = message_traffic_stats_to_variant(peer->traffic_by_message_type);
+                    traffic_by_peer.push_back(peer_traffic);
+                }
+                result["traffic_by_peer"] = traffic_by_peer;
                 return result;
             }
 
@@ -5426,6 +6070,19 @@ namespace graphene {
                 INVOKE_AND_COLLECT_STATISTICS(get_item, id);
             }
 
+            std::vector<char> statistics_gathering_node_delegate_wrapper::get_serialized_block(const item_hash_t &block_id) {
+                INVOKE_AND_COLLECT_STATISTICS(get_serialized_block, block_id);
+            }
+
+            fc::optional<graphene::protocol::signed_block_header> statistics_gathering_node_delegate_wrapper::get_block_header(const item_hash_t &block_id) {
+                INVOKE_AND_COLLECT_STATISTICS(get_block_header, block_id);
+            }
+
+            std::vector<std::vector<char>> statistics_gathering_node_delegate_wrapper::get_serialized_block_range(uint32_t first_block_num,
+                    uint32_t count, uint32_t max_total_size) {
+                INVOKE_AND_COLLECT_STATISTICS(get_serialized_block_range, first_block_num, count, max_total_size);
+            }
+
             std::vector<item_hash_t> statistics_gathering_node_delegate_wrapper::get_blockchain_synopsis(const item_hash_t &reference_point, uint32_t number_of_blocks_after_reference_point) {
                 INVOKE_AND_COLLECT_STATISTICS(get_blockchain_synopsis, reference_point, number_of_blocks_after_reference_point);
             }
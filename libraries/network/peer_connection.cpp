@@ -25,6 +25,8 @@
 
 #include <fc/thread/thread.hpp>
 
+#include <zlib.h>
+
 #ifdef DEFAULT_LOGGER
 # undef DEFAULT_LOGGER
 #endif
@@ -38,6 +40,28 @@
 
 namespace graphene {
     namespace network {
+        bool is_compressible_message_type(uint32_t msg_type) {
+            return msg_type == block_message_type ||
+                   msg_type == trx_message_type ||
+                   msg_type == block_range_message_type ||
+                   msg_type == compact_block_transactions_message_type;
+        }
+
+        fc::optional<message> compress_message(const message &original, message_compression_codec codec) {
+            FC_ASSERT(codec == zlib_compression, "unsupported compression codec ${codec}", ("codec", uint32_t(codec)));
+            uLongf compressed_size = compressBound(original.data.size());
+            std::vector<char> compressed_data(compressed_size);
+            int result = compress2((Bytef *)compressed_data.data(), &compressed_size,
+                    (const Bytef *)original.data.data(), original.data.size(), Z_DEFAULT_COMPRESSION);
+            FC_ASSERT(result == Z_OK, "zlib compression failed", ("result", result));
+            // leave room for the fields of compressed_message
+            if (compressed_size + 16 >= original.data.size()) {
+                return fc::optional<message>();
+            }
+            compressed_data.resize(compressed_size);
+            return message(compressed_message(codec, original.msg_type, original.size, std::move(compressed_data)));
+        }
+
         message peer_connection::real_queued_message::get_message(peer_connection_delegate *) {
             if (message_send_time_field_offset != (size_t)-1) {
                 // patch the current time into the message.  Since this operates on the packed version of the structure,
@@ -80,6 +104,16 @@ namespace graphene {
                 peer_needs_sync_items_from_us(true),
                 we_need_sync_items_from_peer(true),
                 inhibit_fetching_sync_blocks(false),
+                supports_block_ranges(false),
+                sync_window(GRAPHENE_NET_INITIAL_SYNC_WINDOW),
+                sync_batch_bytes_received(0),
+                sync_batch_first_item_received(false),
+                sync_bytes_per_second(0),
+                transactions_known_by_peer(GRAPHENE_NET_KNOWN_TRANSACTIONS_FILTER_SIZE,
+                        GRAPHENE_NET_KNOWN_TRANSACTIONS_FILTER_BITS_PER_ITEM),
+                supports_compact_blocks(false),
+                compression_codec(no_compression),
+                compression_threshold(GRAPHENE_NET_DEFAULT_MESSAGE_COMPRESSION_THRESHOLD),
                 transaction_fetching_inhibited_until(fc::time_point::min()),
                 last_known_fork_block_number(0),
                 firewall_check_state(nullptr)
@@ -243,7 +277,16 @@ namespace graphene {
 
         void peer_connection::on_message(message_oriented_connection *originating_connection, const message &received_message) {
             VERIFY_CORRECT_THREAD();
+            fc::time_point handling_start_time = fc::time_point::now();
+            // compressed messages are already decompressed by the connection, on a read worker for large ones
+            uint32_t received_size = received_message.size;
+            if (received_message.compressed_size != 0) {
+                received_size = received_message.compressed_size;
+                _node->on_message_compression(this, false, received_message.size, received_size);
+            }
             _node->on_message(this, received_message);
+            record_message_traffic(false, received_message.msg_type, sizeof(message_header) + received_size,
+                    fc::time_point::now() - handling_start_time);
         }
 
         void peer_connection::on_connection_closed(message_oriented_connection *originating_connection) {
@@ -272,11 +315,19 @@ namespace graphene {
             while (!_queued_messages.empty()) {
                 _queued_messages.front()->transmission_start_time = fc::time_point::now();
                 message message_to_send = _queued_messages.front()->get_message(_node);
+                uint32_t original_msg_type = message_to_send.msg_type;
+                if (compression_codec != no_compression && compression_threshold &&
+                    message_to_send.size >= compression_threshold &&
+                    is_compressible_message_type(message_to_send.msg_type)) {
+                    message_to_send = compress_message_for_sending(message_to_send);
+                }
                 try {
                     //dlog("peer_connection::send_queued_messages_task() calling message_oriented_connection::send_message() "
                     //     "to send message of type ${type} for peer ${endpoint}",
                     //     ("type", message_to_send.msg_type)("endpoint", get_remote_endpoint()));
                     _message_connection.send_message(message_to_send);
+                    record_message_traffic(true, original_msg_type, sizeof(message_header) + message_to_send.size,
+                            _queued_messages.front()->transmission_start_time - _queued_messages.front()->enqueue_time);
                     //dlog("peer_connection::send_queued_messages_task()'s call to message_oriented_connection::send_message() completed normally for peer ${endpoint}",
                     //     ("endpoint", get_remote_endpoint()));
                 }
@@ -307,6 +358,32 @@ namespace graphene {
             //dlog("leaving peer_connection::send_queued_messages_task() due to queue exhaustion");
         }
 
+        void peer_connection::record_message_traffic(bool outgoing, uint32_t msg_type, size_t bytes,
+                const fc::microseconds &time) {
+            VERIFY_CORRECT_THREAD();
+            traffic_by_message_type[msg_type].record(outgoing, bytes, time);
+            _node->on_message_traffic(this, outgoing, msg_type, bytes, time);
+        }
+
+        message peer_connection::compress_message_for_sending(const message &message_to_send) {
+            VERIFY_CORRECT_THREAD();
+            // broadcast messages are compressed once when they are cached, messages for this peer only are compressed here
+            if (message_to_send.compressed_codec() == uint32_t(compression_codec)) {
+                const auto &compressed = message_to_send.compressed();
+                if (!compressed) {
+                    return message_to_send;
+                }
+                _node->on_message_compression(this, true, message_to_send.size, compressed->size);
+                return *compressed;
+            }
+            fc::optional<message> compressed = compress_message(message_to_send, compression_codec);
+            if (!compressed) {
+                return message_to_send;
+            }
+            _node->on_message_compression(this, true, message_to_send.size, compressed->size);
+            return *compressed;
+        }
+
         void peer_connection::send_queueable_message(std::unique_ptr<queued_message> &&message_to_send) {
             VERIFY_CORRECT_THREAD();
             _total_queued_messages_size += message_to_send->get_size_in_queue();
@@ -36,8 +36,9 @@ namespace graphene {
 
         stcp_socket::stcp_socket()
 //:_buf_len(0)
+                : _recv_aes(std::make_shared<fc::aes_decoder>())
 #ifndef NDEBUG
-                : _read_buffer_in_use(false),
+                , _read_buffer_in_use(false),
                   _write_buffer_in_use(false)
 #endif
         {
@@ -61,7 +62,7 @@ namespace graphene {
 //    ilog("shared secret ${s}", ("s", shared_secret) );
             _send_aes.init(fc::sha256::hash((char *)&_shared_secret, sizeof(_shared_secret)),
                     fc::city_hash_crc_128((char *)&_shared_secret, sizeof(_shared_secret)));
-            _recv_aes.init(fc::sha256::hash((char *)&_shared_secret, sizeof(_shared_secret)),
+            _recv_aes->init(fc::sha256::hash((char *)&_shared_secret, sizeof(_shared_secret)),
                     fc::city_hash_crc_128((char *)&_shared_secret, sizeof(_shared_secret)));
         }
 
@@ -116,7 +117,7 @@ namespace graphene {
                     _sock.read(_read_buffer, 16 - (s % 16), s);
                     s += 16 - (s % 16);
                 }
-                _recv_aes.decode(_read_buffer.get(), s, buffer);
+                _recv_aes->decode(_read_buffer.get(), s, buffer);
                 return s;
             } FC_RETHROW_EXCEPTIONS(warn, "", ("len", len))
         }
@@ -180,6 +181,11 @@ namespace graphene {
             _sock.flush();
         }
 
+        void stcp_socket::read_encrypted(char *buffer, size_t len) {
+            assert((len % 16) == 0);
+            _sock.read(buffer, len);
+        }
+
 
         void stcp_socket::close() {
             try {
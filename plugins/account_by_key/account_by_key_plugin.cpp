@@ -183,6 +183,10 @@ namespace graphene { namespace plugins { namespace account_by_key {
                     boost::program_options::options_description &cfg) {
             }
 
+            void register_indexes(graphene::chain::database &db) {
+                add_plugin_index<key_lookup_index>(db);
+            }
+
             void account_by_key_plugin::plugin_initialize(const boost::program_options::variables_map &options) {
                 try {
                     ilog("Initializing account_by_key plugin");
@@ -192,7 +196,7 @@ namespace graphene { namespace plugins { namespace account_by_key {
                     db.pre_apply_operation.connect([&](operation_notification &o) { my->pre_operation(o); });
                     db.post_apply_operation.connect([&](const operation_notification &o) { my->post_operation(o); });
 
-                    add_plugin_index<key_lookup_index>(db);
+                    register_indexes(db);
                     JSON_RPC_REGISTER_API ( name() ) ;
                 }
                 FC_CAPTURE_AND_RETHROW()
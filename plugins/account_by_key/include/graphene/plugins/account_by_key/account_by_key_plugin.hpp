@@ -18,6 +18,11 @@ namespace graphene {
 
             DEFINE_API_ARGS(get_key_references, json_rpc::msg_pack, vector<vector<account_name_type>>)
 
+            /**
+             *  Adds indexes of the plugin to the database, tools which read the shared memory file call it too
+             */
+            void register_indexes(graphene::chain::database &db);
+
             class account_by_key_plugin : public appbase::plugin<account_by_key_plugin> {
             public:
                 APPBASE_PLUGIN_REQUIRES((json_rpc::plugin))
@@ -52,6 +52,11 @@ namespace graphene { namespace plugins { namespace account_history {
 
     DEFINE_API_ARGS(get_account_history, msg_pack, get_account_history_return_type)
 
+    /**
+     *  Adds indexes of the plugin to the database, tools which read the shared memory file call it too
+     */
+    void register_indexes(graphene::chain::database &db);
+
    /**
     *  This plugin is designed to track a range of operations by account so that one node
     *  doesn't need to hold the full operation history in memory.
@@ -318,6 +318,10 @@ if( options.count(name) ) { \
         cfg.add(cli);
     }
 
+    void register_indexes(graphene::chain::database &db) {
+        graphene::chain::add_plugin_index<account_history_index>(db);
+    }
+
     void plugin::plugin_initialize(const boost::program_options::variables_map& options) {
         ilog("account_history plugin: plugin_initialize() begin");
         pimpl = std::make_unique<plugin_impl>();
@@ -326,7 +330,7 @@ if( options.count(name) ) { \
             pimpl->on_operation(note);
         });
 
-        graphene::chain::add_plugin_index<account_history_index>(pimpl->database);
+        register_indexes(pimpl->database);
 
         using pairstring = std::pair<std::string, std::string>;
         LOAD_VALUE_SET(options, "track-account-range", pimpl->tracked_accounts, pairstring);
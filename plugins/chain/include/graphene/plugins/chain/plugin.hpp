@@ -18,6 +18,8 @@ namespace graphene {
 
             using graphene::plugins::json_rpc::msg_pack;
 
+            DEFINE_API_ARGS(get_undo_state_usage, msg_pack, std::vector<graphene::chain::undo_state_usage>)
+
             class plugin final : public appbase::plugin<plugin> {
             public:
                 APPBASE_PLUGIN_REQUIRES((json_rpc::plugin))
@@ -49,6 +51,15 @@ namespace graphene {
 
                 void check_time_in_block(const protocol::signed_block &block);
 
+                DECLARE_API(
+                    /**
+                     * Undo telemetry of the last applied blocks, the newest first
+                     *
+                     * @param limit number of blocks, 1 by default
+                     */
+                    (get_undo_state_usage)
+                )
+
                 template<typename MultiIndexType>
                 bool has_index() const {
                     return db().has_index<MultiIndexType>();
@@ -48,8 +48,18 @@ namespace chain {
 
         uint32_t block_num_check_free_size = 0;
 
+        uint32_t shared_file_forecast_blocks = 1200;
+        bool store_content_bodies = false;
+        uint32_t undo_usage_history = 1200;
+        uint32_t undo_warning_blocks = 100;
+        bool lean_transaction_objects = false;
+        graphene::chain::shared_memory_mapping_options shared_memory_mapping;
+
         bool skip_virtual_ops = false;
 
+        uint32_t snapshot_export_at = 0;
+        boost::filesystem::path snapshot_import_dir;
+
         graphene::chain::database db;
 
         bool single_write_thread = false;
@@ -83,6 +93,7 @@ namespace chain {
         void accept_transaction(const protocol::signed_transaction &trx);
         void wipe_db(const bfs::path &data_dir, bool wipe_block_log);
         void replay_db(const bfs::path &data_dir, bool force_replay);
+        void export_snapshot();
     };
 
     void plugin::plugin_impl::check_time_in_block(const protocol::signed_block &block) {
@@ -140,11 +151,43 @@ namespace chain {
         }
 
         auto from_block_num = force_replay ? 1 : db.head_block_num() + 1;
+        auto last_block_num = head_block_log ? head_block_log->block_num() : 0;
+
+        // blocks of the block log are irreversible, so the replay stops at the block of the snapshot for the export
+        if (snapshot_export_at != 0) {
+            if (snapshot_export_at < from_block_num || snapshot_export_at > last_block_num) {
+                wlog("Can't export state snapshot of block ${n}: the replay is from block ${from} to ${to}",
+                     ("n", snapshot_export_at)("from", from_block_num)("to", last_block_num));
+            } else {
+                ilog("Replaying blockchain from block num ${from} to ${to} for state snapshot.",
+                     ("from", from_block_num)("to", snapshot_export_at));
+                db.reindex(data_dir, shared_memory_dir, from_block_num, shared_memory_size, snapshot_export_at);
+                if (db.head_block_num() != snapshot_export_at) {
+                    return; // interrupted
+                }
+                export_snapshot();
+                from_block_num = snapshot_export_at + 1;
+                if (from_block_num > last_block_num) {
+                    return;
+                }
+            }
+        }
 
         ilog("Replaying blockchain from block num ${from}.", ("from", from_block_num));
         db.reindex(data_dir, shared_memory_dir, from_block_num, shared_memory_size);
     };
 
+    void plugin::plugin_impl::export_snapshot() {
+        auto snapshot_dir = appbase::app().data_dir() / "snapshots" / std::to_string(snapshot_export_at);
+        try {
+            db.with_strong_read_lock([&]() {
+                db.export_state_snapshot(snapshot_dir);
+            });
+        } catch (const fc::exception &e) {
+            elog("Failed to export state snapshot to ${dir}: ${e}", ("dir", snapshot_dir.string())("e", e.to_detail_string()));
+        }
+    }
+
     void plugin::plugin_impl::accept_transaction(const protocol::signed_transaction &trx) {
         uint32_t skip = db.validate_transaction(trx, db.skip_apply_transaction);
 
@@ -197,7 +240,36 @@ namespace chain {
                 "Minimum free space in shared memory file (see inc-shared-file-size). Default: 500M"
             ) (
                 "block-num-check-free-size", boost::program_options::value<uint32_t>()->default_value(1000),
-                "Check free space in shared memory each N blocks. Default: 1000 (each 3000 seconds)."
+                "Print free space in shared memory each N blocks, if auto-scaling isn't configured. Default: 1000 (each 3000 seconds)."
+            ) (
+                "shared-file-forecast-blocks", boost::program_options::value<uint32_t>()->default_value(1200),
+                "Grow shared memory file in advance, when free space is less than the average allocation of the last blocks multiplied by N. Default: 1200 (one hour)."
+            ) (
+                "store-content-bodies", boost::program_options::value<bool>()->default_value(false),
+                "keep title, body and json_metadata of new contents in the content body store file instead of the shared memory file"
+            ) (
+                "undo-usage-history", boost::program_options::value<uint32_t>()->default_value(1200),
+                "keep undo telemetry of the last N applied blocks for get_undo_state_usage. Default: 1200 (one hour)."
+            ) (
+                "undo-warning-blocks", boost::program_options::value<uint32_t>()->default_value(100),
+                "warn when the last irreversible block is N blocks behind head and undo states grow, 0 disables warnings"
+            ) (
+                "lean-transaction-objects", boost::program_options::value<bool>()->default_value(false),
+                "keep only ids and expirations of recent transactions in the shared memory file, "
+                "their bodies are read from pending transactions, fork database and block log"
+            ) (
+                "shared-file-transparent-huge-pages", boost::program_options::value<bool>()->default_value(false),
+                "advise the kernel to back shared memory file with transparent huge pages, it works for files on tmpfs "
+                "(e.g. shared-file-dir on /dev/shm). For explicit huge pages set shared-file-dir on a hugetlbfs mount."
+            ) (
+                "shared-file-prefault", boost::program_options::value<bool>()->default_value(false),
+                "map all pages of shared memory file at startup and after each resize, so block application doesn't wait for page faults"
+            ) (
+                "shared-file-lock", boost::program_options::value<bool>()->default_value(false),
+                "lock shared memory file in RAM, the memlock limit of the process should be greater than shared-file-size"
+            ) (
+                "shared-file-numa-node", boost::program_options::value<int32_t>()->default_value(-1),
+                "prefer memory of the NUMA node for shared memory file, -1 keeps the default policy"
             ) (
                 "checkpoint", boost::program_options::value<std::vector<std::string>>()->composing(),
                 "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints."
@@ -242,6 +314,14 @@ namespace chain {
             ) (
                 "resync-blockchain", boost::program_options::bool_switch()->default_value(false),
                 "clear chain database and block log"
+            ) (
+                "snapshot-export-at", boost::program_options::value<uint32_t>(),
+                "export state snapshot to snapshots/N in data dir, it works with replay-blockchain: "
+                "the replay stops after irreversible block N from the block log, exports the snapshot and goes on"
+            ) (
+                "snapshot-import", boost::program_options::value<boost::filesystem::path>(),
+                "import state from snapshot directory into an empty data dir, it's skipped when the block log has blocks, "
+                "so the option can stay in config; use it with resync-blockchain to replace existing state"
             ) (
                 "check-locks", boost::program_options::bool_switch()->default_value(false),
                 "Check correctness of chainbase locking"
@@ -291,11 +371,34 @@ namespace chain {
             my->block_num_check_free_size = options.at("block-num-check-free-size").as<uint32_t>();
         }
 
+        my->shared_file_forecast_blocks = options.at("shared-file-forecast-blocks").as<uint32_t>();
+        my->store_content_bodies = options.at("store-content-bodies").as<bool>();
+        my->undo_usage_history = options.at("undo-usage-history").as<uint32_t>();
+        my->undo_warning_blocks = options.at("undo-warning-blocks").as<uint32_t>();
+        my->lean_transaction_objects = options.at("lean-transaction-objects").as<bool>();
+        my->shared_memory_mapping.transparent_huge_pages = options.at("shared-file-transparent-huge-pages").as<bool>();
+        my->shared_memory_mapping.prefault = options.at("shared-file-prefault").as<bool>();
+        my->shared_memory_mapping.lock = options.at("shared-file-lock").as<bool>();
+        my->shared_memory_mapping.numa_node = options.at("shared-file-numa-node").as<int32_t>();
+
         my->replay = options.at("replay-blockchain").as<bool>();
         my->replay_if_corrupted = options.at("replay-if-corrupted").as<bool>();
         my->force_replay = options.at("force-replay-blockchain").as<bool>();
         my->resync = options.at("resync-blockchain").as<bool>();
         my->check_locks = options.at("check-locks").as<bool>();
+
+        if (options.count("snapshot-export-at")) {
+            my->snapshot_export_at = options.at("snapshot-export-at").as<uint32_t>();
+        }
+
+        if (options.count("snapshot-import")) {
+            auto sid = options.at("snapshot-import").as<boost::filesystem::path>();
+            if (sid.is_relative()) {
+                my->snapshot_import_dir = appbase::app().data_dir() / sid;
+            } else {
+                my->snapshot_import_dir = sid;
+            }
+        }
         my->validate_invariants = options.at("validate-database-invariants").as<bool>();
         if (options.count("flush-state-interval")) {
             my->flush_interval = options.at("flush-state-interval").as<uint32_t>();
@@ -311,6 +414,8 @@ namespace chain {
                 my->loaded_checkpoints[item.first] = item.second;
             }
         }
+
+        JSON_RPC_REGISTER_API(name());
     }
 
     void plugin::plugin_startup() {
@@ -343,8 +448,43 @@ namespace chain {
             my->db.set_block_num_check_free_size(my->block_num_check_free_size);
         }
 
+        my->db.set_shared_memory_forecast_blocks(my->shared_file_forecast_blocks);
+        my->db.set_store_content_bodies(my->store_content_bodies);
+        my->db.set_undo_usage_history(my->undo_usage_history);
+        my->db.set_undo_warning_blocks(my->undo_warning_blocks);
+        my->db.set_lean_transaction_objects(my->lean_transaction_objects);
+        my->db.set_shared_memory_mapping_options(my->shared_memory_mapping);
+
         my->db.enable_plugins_on_push_transaction(my->enable_plugins_on_push_transaction);
 
+        if (my->snapshot_export_at && !my->replay) {
+            wlog("snapshot-export-at works only on replay of the block log, use it with replay-blockchain");
+        }
+
+        // the import is one-shot: once blocks are applied after it, a restart must not throw them away
+        auto block_log_file = data_dir / "block_log";
+        if (!my->snapshot_import_dir.empty() &&
+            boost::filesystem::exists(block_log_file) && boost::filesystem::file_size(block_log_file) > 1
+        ) {
+            wlog("Skipping import of state snapshot from ${path}: the block log isn't empty, "
+                 "use resync-blockchain to import it again",
+                 ("path", my->snapshot_import_dir.generic_string()));
+            my->snapshot_import_dir.clear();
+        }
+
+        if (!my->snapshot_import_dir.empty()) {
+            wlog("snapshot import requested: deleting block log and shared memory");
+            my->db.wipe(data_dir, my->shared_memory_dir, true);
+
+            ilog("Importing state snapshot from ${path}", ("path", my->snapshot_import_dir.generic_string()));
+            my->db.open(data_dir, my->shared_memory_dir, CHAIN_INIT_SUPPLY, my->shared_memory_size,
+                        chainbase::database::read_write, my->snapshot_import_dir);
+
+            ilog("Started on blockchain with ${n} blocks", ("n", my->db.head_block_num()));
+            on_sync();
+            return;
+        }
+
         try {
             ilog("Opening shared memory from ${path}", ("path", my->shared_memory_dir.generic_string()));
             my->db.open(data_dir, my->shared_memory_dir, CHAIN_INIT_SUPPLY, my->shared_memory_size, chainbase::database::read_write/*, my->validate_invariants*/ );
@@ -399,6 +539,15 @@ namespace chain {
         return my->accept_block(block, currently_syncing, skip);
     }
 
+    DEFINE_API(plugin, get_undo_state_usage) {
+        const auto n_args = args.args->size();
+        FC_ASSERT(n_args <= 1, "Expected at most 1 argument, got ${n}", ("n", n_args));
+        const uint32_t limit = n_args ? args.args->at(0).as<uint32_t>() : 1;
+        return my->db.with_weak_read_lock([&]() {
+            return my->db.get_undo_state_usage(limit);
+        });
+    }
+
     void plugin::accept_transaction(const protocol::signed_transaction &trx) {
         my->accept_transaction(trx);
     }
@@ -9,7 +9,9 @@
 
 #include <boost/range/iterator_range.hpp>
 #include <boost/algorithm/string.hpp>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <graphene/plugins/json_rpc/plugin.hpp>
 
 #define GET_REQUIRED_FEES_MAX_RECURSION 4
@@ -59,6 +61,11 @@ public:
     void startup() {
     }
 
+    void shutdown();
+
+    /// returns the result of the last scan of index memory, starts a new scan if that one is outdated
+    std::pair<std::vector<index_memory_usage>, fc::time_point_sec> get_index_memory_usage();
+
     // Subscriptions
     void set_subscribe_callback(std::function<void(const variant &)> cb, bool clear_filter);
     void set_pending_transaction_callback(std::function<void(const variant &)> cb);
@@ -77,6 +84,8 @@ public:
     // Accounts
     std::vector<account_api_object> get_accounts(std::vector<std::string> names) const;
     std::vector<optional<account_api_object>> lookup_account_names(const std::vector<std::string> &account_names) const;
+    std::vector<optional<account_fields_api_object>> get_accounts_fields(
+        const std::vector<std::string> &account_names, const std::set<account_field> &fields) const;
     std::set<std::string> lookup_accounts(const std::string &lower_bound_name, uint32_t limit) const;
     uint64_t get_account_count() const;
 
@@ -127,8 +136,51 @@ public:
 private:
 
     graphene::chain::database &_db;
+
+    // memory usage of indexes is scanned in background, as it walks all objects of the state
+    static constexpr uint32_t index_memory_scan_interval_sec = 600;
+    std::mutex _index_memory_mutex;
+    std::vector<index_memory_usage> _index_memory;
+    fc::time_point_sec _index_memory_time;
+    std::future<void> _index_memory_scan;
 };
 
+void plugin::api_impl::shutdown() {
+    std::future<void> scan;
+    {
+        std::lock_guard<std::mutex> lock(_index_memory_mutex);
+        scan = std::move(_index_memory_scan);
+    }
+    // the scan reads the database, so it should finish before the chain plugin closes it
+    if (scan.valid()) {
+        scan.wait();
+    }
+}
+
+std::pair<std::vector<index_memory_usage>, fc::time_point_sec> plugin::api_impl::get_index_memory_usage() {
+    std::lock_guard<std::mutex> lock(_index_memory_mutex);
+
+    bool is_scanning = _index_memory_scan.valid() &&
+        _index_memory_scan.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    bool is_outdated = _index_memory_time == fc::time_point_sec() ||
+        fc::time_point::now() - _index_memory_time > fc::seconds(index_memory_scan_interval_sec);
+
+    if (!is_scanning && is_outdated) {
+        _index_memory_scan = std::async(std::launch::async, [this]() {
+            try {
+                auto usage = _db.get_index_memory_usage();
+                std::lock_guard<std::mutex> lock(_index_memory_mutex);
+                _index_memory = std::move(usage);
+                _index_memory_time = fc::time_point::now();
+            } catch (const fc::exception &e) {
+                wlog("Scan of index memory usage failed: ${e}", ("e", e.to_detail_string()));
+            }
+        });
+    }
+
+    return std::make_pair(_index_memory, _index_memory_time);
+}
+
 
 //void find_accounts(std::set<std::string> &accounts, const discussion &d) {
 //    accounts.insert(d.author);
@@ -216,9 +268,9 @@ DEFINE_API(plugin, get_block_header) {
 }
 
 optional<block_header> plugin::api_impl::get_block_header(uint32_t block_num) const {
-    auto result = database().fetch_block_by_number(block_num);
+    auto result = database().fetch_shared_block_by_number(block_num);
     if (result) {
-        return *result;
+        return block_header(*result);
     }
     return {};
 }
@@ -231,7 +283,11 @@ DEFINE_API(plugin, get_block) {
 }
 
 optional<signed_block> plugin::api_impl::get_block(uint32_t block_num) const {
-    return database().fetch_block_by_number(block_num);
+    auto result = database().fetch_shared_block_by_number(block_num);
+    if (result) {
+        return *result;
+    }
+    return {};
 }
 
 DEFINE_API(plugin, set_block_applied_callback) {
@@ -381,6 +437,96 @@ std::vector<optional<account_api_object>> plugin::api_impl::lookup_account_names
     return result;
 }
 
+DEFINE_API(plugin, get_accounts_fields) {
+    size_t n_args = args.args->size();
+    CHECK_ARGS_COUNT(1, 2)
+    auto account_names = args.args->at(0).as<vector<std::string> >();
+    std::set<account_field> fields;
+    if (n_args > 1) {
+        fields = args.args->at(1).as<std::set<account_field> >();
+    }
+    return my->database().with_weak_read_lock([&]() {
+        return my->get_accounts_fields(account_names, fields);
+    });
+}
+
+std::vector<optional<account_fields_api_object>> plugin::api_impl::get_accounts_fields(
+    const std::vector<std::string> &account_names, const std::set<account_field> &fields
+) const {
+    FC_ASSERT(account_names.size() <= 1000, "Cannot retrieve more than 1000 accounts at a time.");
+
+    auto has_field = [&](account_field f) {
+        return fields.empty() || fields.count(f);
+    };
+
+    std::vector<optional<account_fields_api_object>> result(account_names.size());
+
+    // names are resolved in index order, so neighbouring names cost one step instead of a search from the root
+    std::vector<std::pair<account_name_type, std::size_t>> order;
+    order.reserve(account_names.size());
+    for (std::size_t i = 0; i < account_names.size(); ++i) {
+        order.emplace_back(account_names[i], i);
+    }
+    std::sort(order.begin(), order.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    const auto &idx = _db.get_index<account_index>().indices().get<by_name>();
+    const auto &auth_idx = _db.get_index<account_authority_index>().indices().get<by_account>();
+    const auto &vidx = _db.get_index<witness_vote_index>().indices().get<by_account_witness>();
+    auto itr = idx.begin();
+
+    for (const auto &o : order) {
+        if (itr != idx.end() && itr->name < o.first) {
+            auto next = std::next(itr);
+            itr = (next != idx.end() && !(next->name < o.first)) ? next : idx.lower_bound(o.first);
+        }
+        if (itr == idx.end() || itr->name != o.first) {
+            continue;
+        }
+
+        account_fields_api_object entry(*itr);
+
+        if (has_field(balances)) {
+            entry.balances = account_balances_api_object(*itr);
+        }
+
+        if (has_field(vesting)) {
+            entry.vesting = account_vesting_api_object(*itr);
+        }
+
+        if (has_field(authorities)) {
+            auto auth_itr = auth_idx.find(itr->name);
+            if (auth_itr != auth_idx.end()) {
+                entry.authorities = account_authorities_api_object(*auth_itr);
+                entry.authorities->memo_key = itr->memo_key;
+            }
+        }
+
+#ifndef IS_LOW_MEM
+        if (has_field(metadata)) {
+            const auto *meta = _db.find<account_metadata_object, by_account>(itr->name);
+            if (meta != nullptr) {
+                entry.json_metadata = to_string(meta->json_metadata);
+            }
+        }
+#endif
+
+        if (has_field(witness_votes)) {
+            entry.witness_votes = std::set<std::string>();
+            auto vitr = vidx.lower_bound(boost::make_tuple(itr->id, witness_id_type()));
+            while (vitr != vidx.end() && vitr->account == itr->id) {
+                entry.witness_votes->insert(_db.get(vitr->witness).owner);
+                ++vitr;
+            }
+        }
+
+        result[o.second] = std::move(entry);
+    }
+
+    return result;
+}
+
 DEFINE_API(plugin, lookup_accounts) {
     CHECK_ARG_SIZE(2)
     account_name_type lower_bound_name = args.args->at(0).as<account_name_type>();
@@ -721,12 +867,23 @@ DEFINE_API(plugin, get_database_info) {
     info.reserved_size = db.reserved_memory();
     info.used_size = info.total_size - info.free_size - info.reserved_size;
 
+    info.growth_per_block = db.shared_memory_growth_per_block();
+    info.forecast_blocks = db.shared_memory_forecast_blocks();
+    info.forecast_size = db.shared_memory_forecast();
+    info.resize_count = db.shared_memory_resize_count();
+    info.bad_alloc_resize_count = db.shared_memory_bad_alloc_count();
+    info.last_resize_block_num = db.last_shared_memory_resize_block_num();
+
     info.index_list.reserve(db.index_list_size());
 
     for (auto it = db.index_list_begin(), et = db.index_list_end(); et != it; ++it) {
         info.index_list.push_back({(*it)->name(), (*it)->size()});
     }
 
+    auto index_memory = my->get_index_memory_usage();
+    info.index_memory = std::move(index_memory.first);
+    info.index_memory_time = index_memory.second;
+
     return info;
 }
 
@@ -796,4 +953,8 @@ void plugin::plugin_startup() {
     my->startup();
 }
 
+void plugin::plugin_shutdown() {
+    my->shutdown();
+}
+
 } } } // graphene::plugins::database_api
@@ -0,0 +1,121 @@
+#ifndef CHAIN_ACCOUNT_FIELDS_API_OBJ_HPP
+#define CHAIN_ACCOUNT_FIELDS_API_OBJ_HPP
+
+#include <graphene/chain/account_object.hpp>
+
+namespace graphene {
+    namespace plugins {
+        namespace database_api {
+
+            using protocol::asset;
+            using protocol::authority;
+            using protocol::share_type;
+            using protocol::public_key_type;
+            using graphene::protocol::account_name_type;
+            using graphene::chain::account_object;
+
+            /**
+             *  Groups of account fields which can be requested from get_accounts_fields,
+             *  an empty list of groups means all of them
+             */
+            enum account_field {
+                balances,
+                vesting,
+                authorities,
+                metadata,
+                witness_votes
+            };
+
+            struct account_balances_api_object {
+                account_balances_api_object(const account_object &a) : balance(a.balance),
+                        curation_rewards(a.curation_rewards), posting_rewards(a.posting_rewards) {
+                }
+
+                account_balances_api_object() {
+                }
+
+                asset balance;
+                share_type curation_rewards;
+                share_type posting_rewards;
+            };
+
+            struct account_vesting_api_object {
+                account_vesting_api_object(const account_object &a) : vesting_shares(a.vesting_shares),
+                        delegated_vesting_shares(a.delegated_vesting_shares),
+                        received_vesting_shares(a.received_vesting_shares),
+                        vesting_withdraw_rate(a.vesting_withdraw_rate), next_vesting_withdrawal(a.next_vesting_withdrawal),
+                        withdrawn(a.withdrawn), to_withdraw(a.to_withdraw), withdraw_routes(a.withdraw_routes),
+                        energy(a.energy), last_vote_time(a.last_vote_time) {
+                }
+
+                account_vesting_api_object() {
+                }
+
+                asset vesting_shares;
+                asset delegated_vesting_shares;
+                asset received_vesting_shares;
+                asset vesting_withdraw_rate;
+                time_point_sec next_vesting_withdrawal;
+                share_type withdrawn;
+                share_type to_withdraw;
+                uint16_t withdraw_routes = 0;
+                int16_t energy = 0;
+                time_point_sec last_vote_time;
+            };
+
+            struct account_authorities_api_object {
+                account_authorities_api_object(const graphene::chain::account_authority_object &a) :
+                        owner(authority(a.owner)), active(authority(a.active)), posting(authority(a.posting)),
+                        last_owner_update(a.last_owner_update) {
+                }
+
+                account_authorities_api_object() {
+                }
+
+                authority owner;
+                authority active;
+                authority posting;
+                public_key_type memo_key;
+                time_point_sec last_owner_update;
+            };
+
+            /**
+             *  Projection of an account, only requested field groups are filled
+             */
+            struct account_fields_api_object {
+                account_fields_api_object(const account_object &a) : id(a.id), name(a.name) {
+                }
+
+                account_fields_api_object() {
+                }
+
+                account_object::id_type id;
+                account_name_type name;
+
+                fc::optional<account_balances_api_object> balances;
+                fc::optional<account_vesting_api_object> vesting;
+                fc::optional<account_authorities_api_object> authorities;
+                fc::optional<std::string> json_metadata;
+                fc::optional<std::set<std::string>> witness_votes;
+            };
+        }
+    }
+}
+
+FC_REFLECT_ENUM(graphene::plugins::database_api::account_field,
+                (balances)(vesting)(authorities)(metadata)(witness_votes))
+
+FC_REFLECT((graphene::plugins::database_api::account_balances_api_object),
+           (balance)(curation_rewards)(posting_rewards))
+
+FC_REFLECT((graphene::plugins::database_api::account_vesting_api_object),
+           (vesting_shares)(delegated_vesting_shares)(received_vesting_shares)(vesting_withdraw_rate)
+           (next_vesting_withdrawal)(withdrawn)(to_withdraw)(withdraw_routes)(energy)(last_vote_time))
+
+FC_REFLECT((graphene::plugins::database_api::account_authorities_api_object),
+           (owner)(active)(posting)(memo_key)(last_owner_update))
+
+FC_REFLECT((graphene::plugins::database_api::account_fields_api_object),
+           (id)(name)(balances)(vesting)(authorities)(json_metadata)(witness_votes))
+
+#endif //CHAIN_ACCOUNT_FIELDS_API_OBJ_HPP
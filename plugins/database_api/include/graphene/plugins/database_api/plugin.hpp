@@ -13,7 +13,9 @@
 #include <graphene/plugins/database_api/api_objects/owner_authority_history_api_object.hpp>
 #include <graphene/plugins/database_api/api_objects/account_recovery_request_api_object.hpp>
 #include <graphene/plugins/database_api/api_objects/proposal_api_object.hpp>
+#include <graphene/plugins/database_api/api_objects/account_fields_api_object.hpp>
 #include <graphene/plugins/chain/plugin.hpp>
+#include <graphene/chain/index_memory_usage.hpp>
 
 #include <graphene/api/chain_api_properties.hpp>
 
@@ -41,7 +43,18 @@ struct database_info {
     std::size_t reserved_size;
     std::size_t used_size;
 
+    std::size_t growth_per_block;
+    uint32_t forecast_blocks;
+    std::size_t forecast_size;
+    uint32_t resize_count;
+    uint32_t bad_alloc_resize_count;
+    uint32_t last_resize_block_num;
+
     std::vector<database_index_info> index_list;
+
+    /// bytes taken by each index, from the last background scan which finished at index_memory_time
+    std::vector<graphene::chain::index_memory_usage> index_memory;
+    fc::time_point_sec index_memory_time;
 };
 
 struct scheduled_hardfork {
@@ -106,6 +119,7 @@ DEFINE_API_ARGS(get_hardfork_version,             msg_pack, hardfork_version)
 DEFINE_API_ARGS(get_next_scheduled_hardfork,      msg_pack, scheduled_hardfork)
 DEFINE_API_ARGS(get_accounts,                     msg_pack, std::vector<account_api_object>)
 DEFINE_API_ARGS(lookup_account_names,             msg_pack, std::vector<optional<account_api_object> >)
+DEFINE_API_ARGS(get_accounts_fields,              msg_pack, std::vector<optional<account_fields_api_object> >)
 DEFINE_API_ARGS(lookup_accounts,                  msg_pack, std::set<std::string>)
 DEFINE_API_ARGS(get_account_count,                msg_pack, uint64_t)
 DEFINE_API_ARGS(get_owner_history,                msg_pack, std::vector<owner_authority_history_api_object>)
@@ -152,7 +166,7 @@ public:
 
     void plugin_startup() override;
 
-    void plugin_shutdown() override{}
+    void plugin_shutdown() override;
 
     plugin();
 
@@ -246,6 +260,15 @@ public:
          */
         (lookup_account_names)
 
+        /**
+         * @brief Get selected groups of fields for a batch of accounts
+         * @param account_names Names of the accounts to retrieve -- must not exceed 1000
+         * @param fields Field groups to fill (balances, vesting, authorities, metadata, witness_votes),
+         *        all groups if empty
+         * @return Projections of the accounts in the order of names, null for unknown names
+         */
+        (get_accounts_fields)
+
         /**
          * @brief Get names and IDs for registered accounts
          * @param lower_bound_name Lower bound of the first name to return
@@ -354,4 +377,6 @@ FC_REFLECT((graphene::plugins::database_api::get_tags_used_by_author), (tags))
 FC_REFLECT((graphene::plugins::database_api::signed_block_api_object), (block_id)(signing_key)(transaction_ids))
 
 FC_REFLECT((graphene::plugins::database_api::database_index_info), (name)(record_count))
-FC_REFLECT((graphene::plugins::database_api::database_info), (total_size)(free_size)(reserved_size)(used_size)(index_list))
+FC_REFLECT((graphene::plugins::database_api::database_info), (total_size)(free_size)(reserved_size)(used_size)
+    (growth_per_block)(forecast_blocks)(forecast_size)(resize_count)(bad_alloc_resize_count)(last_resize_block_num)
+    (index_list)(index_memory)(index_memory_time))
@@ -127,6 +127,7 @@ namespace graphene {
                         b.account = o.account;
                         b.content = c.id;
                         b.reblogged_on = db().head_block_time();
+                        b.blogged_on = b.reblogged_on;
                         b.blog_feed_id = next_blog_id;
                     });
 
@@ -148,7 +149,7 @@ namespace graphene {
                     const auto &feed_idx = db().get_index<feed_index>().indices().get<by_feed>();
                     const auto &content_idx = db().get_index<feed_index>().indices().get<by_content>();
                     const auto &idx = db().get_index<follow_index>().indices().get<by_following_follower>();
-                    auto itr = idx.find(o.account);
+                    auto itr = _plugin->pull_feed() ? idx.end() : idx.find(o.account);
 
                     while (itr != idx.end() && itr->following == o.account) {
 
@@ -88,6 +88,8 @@ namespace graphene {
                 account_name_type account;
                 content_object::id_type content;
                 time_point_sec reblogged_on;
+                /// time of the post or the reblog, the pull feed seeks pages by it
+                time_point_sec blogged_on;
                 uint32_t blog_feed_id = 0;
             };
 
@@ -191,6 +193,7 @@ namespace graphene {
 
             struct by_blog;
             struct by_old_blog;
+            struct by_blog_time;
 
             typedef multi_index_container<blog_object,
                     indexed_by<ordered_unique<tag<by_id>, member<blog_object, blog_id_type, &blog_object::id>>,
@@ -202,6 +205,12 @@ namespace graphene {
                                     member<blog_object, account_name_type, &blog_object::account>,
                                     member<blog_object, uint32_t, &blog_object::blog_feed_id> >,
                                     composite_key_compare<std::less<account_name_type>, std::less<uint32_t>>>,
+                            ordered_unique<tag<by_blog_time>, composite_key<blog_object,
+                                    member<blog_object, account_name_type, &blog_object::account>,
+                                    member<blog_object, time_point_sec, &blog_object::blogged_on>,
+                                    member<blog_object, uint32_t, &blog_object::blog_feed_id> >,
+                                    composite_key_compare<std::less<account_name_type>, std::greater<time_point_sec>,
+                                            std::greater<uint32_t>>>,
                             ordered_unique<tag<by_content>, composite_key<blog_object,
                                     member<blog_object, content_object::id_type, &blog_object::content>,
                                     member<blog_object, account_name_type, &blog_object::account> >,
@@ -238,7 +247,7 @@ FC_REFLECT((graphene::plugins::follow::feed_object),
            (id)(account)(first_reblogged_by)(first_reblogged_on)(reblogged_by)(content)(reblogs)(account_feed_id))
 CHAINBASE_SET_INDEX_TYPE(graphene::plugins::follow::feed_object, graphene::plugins::follow::feed_index)
 
-FC_REFLECT((graphene::plugins::follow::blog_object), (id)(account)(content)(reblogged_on)(blog_feed_id))
+FC_REFLECT((graphene::plugins::follow::blog_object), (id)(account)(content)(reblogged_on)(blogged_on)(blog_feed_id))
 CHAINBASE_SET_INDEX_TYPE(graphene::plugins::follow::blog_object, graphene::plugins::follow::blog_index)
 
 FC_REFLECT((graphene::plugins::follow::follow_count_object), (id)(account)(follower_count)(following_count))
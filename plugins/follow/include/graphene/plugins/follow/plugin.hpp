@@ -19,6 +19,10 @@ namespace graphene { namespace plugins { namespace follow {
     DEFINE_API_ARGS(get_reblogged_by,        msg_pack, std::vector<account_name_type>)
     DEFINE_API_ARGS(get_blog_authors,        msg_pack, blog_authors_r)
 
+    /**
+     *  Adds indexes of the plugin to the database, tools which read the shared memory file call it too
+     */
+    void register_indexes(graphene::chain::database &db);
 
     class plugin final : public appbase::plugin<plugin> {
     public:
@@ -58,6 +62,9 @@ namespace graphene { namespace plugins { namespace follow {
 
         uint32_t max_feed_size();
 
+        /// true if feeds are assembled from blogs at query time instead of being stored per follower
+        bool pull_feed();
+
         void plugin_startup() override;
 
         void plugin_shutdown() override {}
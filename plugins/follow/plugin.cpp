@@ -7,7 +7,10 @@
 #include <graphene/chain/operation_notification.hpp>
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/content_object.hpp>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <graphene/plugins/json_rpc/plugin.hpp>
 #include <graphene/chain/index.hpp>
 
@@ -121,7 +124,8 @@ namespace graphene {
 
                         const auto &idx = db.get_index<follow_index>().indices().get<by_following_follower>();
                         const auto &content_idx = db.get_index<feed_index>().indices().get<by_content>();
-                        auto itr = idx.find(op.author);
+                        // in pull mode feeds are merged from blogs on request, so nothing is pushed to followers
+                        auto itr = _plugin.pull_feed() ? idx.end() : idx.find(op.author);
 
                         const auto &feed_idx = db.get_index<feed_index>().indices().get<by_feed>();
 
@@ -168,6 +172,7 @@ namespace graphene {
                             db.create<blog_object>([&](blog_object &b) {
                                 b.account = op.author;
                                 b.content = c.id;
+                                b.blogged_on = c.created;
                                 b.blog_feed_id = next_id;
                             });
 
@@ -193,6 +198,25 @@ namespace graphene {
                 }
             }
 
+            /**
+             *  Feed entry assembled from blogs in pull mode. Its entry id is the time the content got into
+             *  the feed (creation time for posts, reblog time for reblogs) in seconds, so paging by the last
+             *  returned entry id is inclusive and may repeat entries which share the same second.
+             */
+            struct pull_feed_item {
+                content_object::id_type content;
+                time_point_sec time;
+                std::vector<account_name_type> reblog_by;
+            };
+
+            struct pull_feed_cache_entry {
+                block_id_type block_id;
+                uint32_t limit = 0;
+                std::vector<pull_feed_item> items;
+                /// position of the reader in pull_feed_cache_order_
+                std::list<account_name_type>::iterator order_itr;
+            };
+
             struct plugin::impl final {
             public:
                 impl() : database_(appbase::app().get_plugin<chain::plugin>().db()) {
@@ -279,10 +303,31 @@ namespace graphene {
 
                 blog_authors_r get_blog_authors(account_name_type );
 
+                std::vector<pull_feed_item> merge_blogs(
+                        account_name_type account,
+                        uint32_t start_entry_id,
+                        uint32_t limit);
+
+                std::vector<pull_feed_item> get_pull_feed(
+                        account_name_type account,
+                        uint32_t start_entry_id,
+                        uint32_t limit);
+
                 graphene::chain::database &database_;
 
                 uint32_t max_feed_size_ = 500;
 
+                bool pull_feed_ = false;
+
+                uint32_t pull_feed_cache_size_ = 100;
+
+                std::mutex pull_feed_cache_mutex_;
+
+                std::map<account_name_type, pull_feed_cache_entry> pull_feed_cache_;
+
+                /// readers of cached feeds from the most recently used to the least recently used
+                std::list<account_name_type> pull_feed_cache_order_;
+
                 std::shared_ptr<generic_custom_operation_interpreter<
                         follow::follow_plugin_operation>> _custom_operation_interpreter;
             };
@@ -295,10 +340,23 @@ namespace graphene {
                                                     boost::program_options::options_description &cfg) {
                 cli.add_options()
                     ("follow-max-feed-size", boost::program_options::value<uint32_t>()->default_value(500),
-                        "Set the maximum size of cached feed for an account");
+                        "Set the maximum size of cached feed for an account")
+                    ("follow-feed-mode", boost::program_options::value<std::string>()->default_value("push"),
+                        "How feeds are built: 'push' stores a feed entry for every follower on each post, "
+                        "'pull' merges blogs of followed accounts on request (existing feed entries are not used)")
+                    ("follow-feed-cache-size", boost::program_options::value<uint32_t>()->default_value(100),
+                        "Set the number of readers whose first feed page is cached in pull mode until next block");
                 cfg.add(cli);
             }
 
+            void register_indexes(graphene::chain::database &db) {
+                graphene::chain::add_plugin_index<follow_index>(db);
+                graphene::chain::add_plugin_index<feed_index>(db);
+                graphene::chain::add_plugin_index<blog_index>(db);
+                graphene::chain::add_plugin_index<follow_count_index>(db);
+                graphene::chain::add_plugin_index<blog_author_stats_index>(db);
+            }
+
             void plugin::plugin_initialize(const boost::program_options::variables_map &options) {
                 try {
                     ilog("Intializing follow plugin");
@@ -312,17 +370,28 @@ namespace graphene {
                     db.post_apply_operation.connect([&](const operation_notification &o) {
                         pimpl->post_operation(o, *this);
                     });
-                    graphene::chain::add_plugin_index<follow_index>(db);
-                    graphene::chain::add_plugin_index<feed_index>(db);
-                    graphene::chain::add_plugin_index<blog_index>(db);
-                    graphene::chain::add_plugin_index<follow_count_index>(db);
-                    graphene::chain::add_plugin_index<blog_author_stats_index>(db);
+                    register_indexes(db);
 
                     if (options.count("follow-max-feed-size")) {
                         uint32_t feed_size = options["follow-max-feed-size"].as<uint32_t>();
                         pimpl->max_feed_size_ = feed_size;
                     }
 
+                    if (options.count("follow-feed-mode")) {
+                        auto feed_mode = options["follow-feed-mode"].as<std::string>();
+                        FC_ASSERT(feed_mode == "push" || feed_mode == "pull",
+                            "Unknown follow-feed-mode ${m}, expected push or pull", ("m", feed_mode));
+                        pimpl->pull_feed_ = (feed_mode == "pull");
+                    }
+
+                    if (options.count("follow-feed-cache-size")) {
+                        pimpl->pull_feed_cache_size_ = options["follow-feed-cache-size"].as<uint32_t>();
+                    }
+
+                    if (pimpl->pull_feed_) {
+                        ilog("Follow plugin builds feeds in pull mode");
+                    }
+
                     JSON_RPC_REGISTER_API ( name() ) ;
                 } FC_CAPTURE_AND_RETHROW()
             }
@@ -334,6 +403,10 @@ namespace graphene {
                 return pimpl->max_feed_size_;
             }
 
+            bool plugin::pull_feed() {
+                return pimpl->pull_feed_;
+            }
+
             plugin::~plugin() {
 
             }
@@ -409,14 +482,33 @@ namespace graphene {
                     uint32_t limit) {
                 FC_ASSERT(limit <= 500, "Cannot retrieve more than 500 feed entries at a time.");
 
-                if (entry_id == 0) {
-                    entry_id = ~0;
-                }
-
                 std::vector<feed_entry> result;
                 result.reserve(limit);
 
                 const auto &db = database();
+
+                if (pull_feed_) {
+                    for (auto &item : get_pull_feed(account, entry_id, limit)) {
+                        const auto &content = db.get(item.content);
+                        feed_entry entry;
+                        entry.author = content.author;
+                        entry.permlink = to_string(content.permlink);
+                        entry.entry_id = item.time.sec_since_epoch();
+                        if (!item.reblog_by.empty()) {
+                            entry.reblog_by.reserve(item.reblog_by.size());
+                            for (const auto &a : item.reblog_by) {
+                                entry.reblog_by.push_back(a);
+                            }
+                            entry.reblog_on = item.time;
+                        }
+                        result.push_back(entry);
+                    }
+                    return result;
+                }
+
+                if (entry_id == 0) {
+                    entry_id = ~0;
+                }
                 const auto &feed_idx = db.get_index<feed_index>().indices().get<by_feed>();
                 auto itr = feed_idx.lower_bound(boost::make_tuple(account, entry_id));
 
@@ -448,14 +540,31 @@ namespace graphene {
                     uint32_t limit) {
                 FC_ASSERT(limit <= 500, "Cannot retrieve more than 500 feed entries at a time.");
 
-                if (entry_id == 0) {
-                    entry_id = ~0;
-                }
-
                 std::vector<content_feed_entry> result;
                 result.reserve(limit);
 
                 const auto &db = database();
+
+                if (pull_feed_) {
+                    for (auto &item : get_pull_feed(account, entry_id, limit)) {
+                        content_feed_entry entry;
+                        entry.content = content_api_object(db.get(item.content), db);
+                        entry.entry_id = item.time.sec_since_epoch();
+                        if (!item.reblog_by.empty()) {
+                            entry.reblog_by.reserve(item.reblog_by.size());
+                            for (const auto &a : item.reblog_by) {
+                                entry.reblog_by.push_back(a);
+                            }
+                            entry.reblog_on = item.time;
+                        }
+                        result.push_back(entry);
+                    }
+                    return result;
+                }
+
+                if (entry_id == 0) {
+                    entry_id = ~0;
+                }
                 const auto &feed_idx = db.get_index<feed_index>().indices().get<by_feed>();
                 auto itr = feed_idx.lower_bound(boost::make_tuple(account, entry_id));
 
@@ -480,6 +589,132 @@ namespace graphene {
                 return result;
             }
 
+            std::vector<pull_feed_item> plugin::impl::merge_blogs(
+                    account_name_type account,
+                    uint32_t start_entry_id,
+                    uint32_t limit) {
+                const auto &db = database();
+                const auto &blog_idx = db.get_index<blog_index>().indices().get<by_blog_time>();
+                typedef blog_index::index<by_blog_time>::type::const_iterator blog_iterator;
+
+                struct blog_cursor {
+                    time_point_sec time;
+                    blog_id_type id;
+                    blog_iterator itr;
+                    account_name_type blogger;
+
+                    bool operator<(const blog_cursor &o) const {
+                        return std::tie(time, id) < std::tie(o.time, o.id);
+                    }
+                };
+
+                std::priority_queue<blog_cursor> heads;
+
+                // entries of every blog are ordered by time, so each followed blog is a sorted stream
+                // and the feed is a k-way merge of them, a deep page seeks each blog straight to the cursor
+                auto push_head = [&](blog_iterator itr, const account_name_type &blogger) {
+                    if (itr != blog_idx.end() && itr->account == blogger) {
+                        heads.push(blog_cursor{itr->blogged_on, itr->id, itr, blogger});
+                    }
+                };
+
+                const auto &follow_idx = db.get_index<follow_index>().indices().get<by_follower_following>();
+                for (auto itr = follow_idx.lower_bound(account); itr != follow_idx.end() && itr->follower == account; ++itr) {
+                    if (itr->what & (1 << blog)) {
+                        if (start_entry_id == 0) {
+                            push_head(blog_idx.lower_bound(itr->following), itr->following);
+                        } else {
+                            push_head(blog_idx.lower_bound(boost::make_tuple(
+                                itr->following, time_point_sec(start_entry_id))), itr->following);
+                        }
+                    }
+                }
+
+                std::vector<pull_feed_item> result;
+                result.reserve(limit);
+                std::map<content_object::id_type, size_t> seen;
+
+                while (!heads.empty() && result.size() < limit) {
+                    auto head = heads.top();
+                    heads.pop();
+
+                    const auto &b = *head.itr;
+                    bool is_reblog = (b.reblogged_on != time_point_sec());
+                    auto seen_itr = seen.find(b.content);
+
+                    if (seen_itr == seen.end()) {
+                        seen.emplace(b.content, result.size());
+                        pull_feed_item item;
+                        item.content = b.content;
+                        item.time = head.time;
+                        if (is_reblog) {
+                            item.reblog_by.push_back(b.account);
+                        }
+                        result.push_back(std::move(item));
+                    } else if (is_reblog) {
+                        result[seen_itr->second].reblog_by.push_back(b.account);
+                    }
+
+                    push_head(++head.itr, head.blogger);
+                }
+
+                return result;
+            }
+
+            std::vector<pull_feed_item> plugin::impl::get_pull_feed(
+                    account_name_type account,
+                    uint32_t start_entry_id,
+                    uint32_t limit) {
+                if (start_entry_id != 0 || pull_feed_cache_size_ == 0) {
+                    return merge_blogs(account, start_entry_id, limit);
+                }
+
+                auto block_id = database().head_block_id();
+                {
+                    std::lock_guard<std::mutex> lock(pull_feed_cache_mutex_);
+                    auto itr = pull_feed_cache_.find(account);
+                    if (itr != pull_feed_cache_.end() && itr->second.block_id == block_id && itr->second.limit >= limit) {
+                        pull_feed_cache_order_.splice(
+                            pull_feed_cache_order_.begin(), pull_feed_cache_order_, itr->second.order_itr);
+                        auto &items = itr->second.items;
+                        return std::vector<pull_feed_item>(items.begin(), items.begin() + std::min<size_t>(limit, items.size()));
+                    }
+                }
+
+                auto result = merge_blogs(account, start_entry_id, limit);
+
+                std::lock_guard<std::mutex> lock(pull_feed_cache_mutex_);
+                auto itr = pull_feed_cache_.find(account);
+                if (itr == pull_feed_cache_.end()) {
+                    if (pull_feed_cache_.size() >= pull_feed_cache_size_) {
+                        for (auto stale_itr = pull_feed_cache_.begin(); stale_itr != pull_feed_cache_.end();) {
+                            if (stale_itr->second.block_id != block_id) {
+                                pull_feed_cache_order_.erase(stale_itr->second.order_itr);
+                                stale_itr = pull_feed_cache_.erase(stale_itr);
+                            } else {
+                                ++stale_itr;
+                            }
+                        }
+                        if (pull_feed_cache_.size() >= pull_feed_cache_size_) {
+                            pull_feed_cache_.erase(pull_feed_cache_order_.back());
+                            pull_feed_cache_order_.pop_back();
+                        }
+                    }
+                    itr = pull_feed_cache_.emplace(account, pull_feed_cache_entry()).first;
+                    itr->second.order_itr = pull_feed_cache_order_.insert(pull_feed_cache_order_.begin(), account);
+                } else {
+                    pull_feed_cache_order_.splice(
+                        pull_feed_cache_order_.begin(), pull_feed_cache_order_, itr->second.order_itr);
+                }
+
+                auto &entry = itr->second;
+                entry.block_id = block_id;
+                entry.limit = limit;
+                entry.items = result;
+
+                return result;
+            }
+
             std::vector<blog_entry> plugin::impl::get_blog_entries(
                     account_name_type account,
                     uint32_t entry_id,
@@ -97,11 +97,11 @@ namespace mongo_db {
                 body << "beneficiaries" << ben_array;
             }
 
-            auto& content = db_.get_content_type(content_id_type(content.id));
+            auto& content_type = db_.get_content_type(content_id_type(content.id));
 
-            format_value(body, "title", content.title);
-            format_value(body, "body", content.body);
-            format_value(body, "json_metadata", content.json_metadata);
+            format_value(body, "title", db_.get_content_title(content_type));
+            format_value(body, "body", db_.get_content_body(content_type));
+            format_value(body, "json_metadata", db_.get_content_json_metadata(content_type));
 
             std::string root_oid;
             if (content.parent_author == CHAIN_ROOT_POST_PARENT) {
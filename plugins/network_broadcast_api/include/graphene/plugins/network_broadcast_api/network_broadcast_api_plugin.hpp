@@ -40,6 +40,7 @@ namespace graphene {
             DEFINE_API_ARGS(broadcast_transaction_synchronous,   msg_pack, void_type)
             DEFINE_API_ARGS(broadcast_block,                     msg_pack, void_type)
             DEFINE_API_ARGS(broadcast_transaction_with_callback, msg_pack, void_type)
+            DEFINE_API_ARGS(get_network_usage_stats,             msg_pack, fc::variant_object)
 
 
             using namespace appbase;
@@ -62,6 +63,7 @@ namespace graphene {
                         (broadcast_transaction_synchronous)
                         (broadcast_block)
                         (broadcast_transaction_with_callback)
+                        (get_network_usage_stats)
                 )
 
                 bool check_max_block_age(int32_t max_block_age) const;
@@ -124,6 +124,10 @@ namespace graphene {
 
             }
 
+            DEFINE_API(network_broadcast_api_plugin, get_network_usage_stats) {
+                return pimpl->_p2p.get_network_usage_stats();
+            }
+
             bool network_broadcast_api_plugin::check_max_block_age(int32_t max_block_age) const {
                 return pimpl->_chain.db().with_weak_read_lock([&]() {
                     if (max_block_age < 0) {
@@ -86,6 +86,9 @@ namespace graphene { namespace plugins { namespace operation_history {
 
 } } } // graphene::plugins::operation_history
 
+FC_REFLECT((graphene::plugins::operation_history::operation_object),
+    (id)(trx_id)(block)(trx_in_block)(op_in_trx)(virtual_op)(timestamp)(serialized_op))
+
 CHAINBASE_SET_INDEX_TYPE(
     graphene::plugins::operation_history::operation_object,
     graphene::plugins::operation_history::operation_index)
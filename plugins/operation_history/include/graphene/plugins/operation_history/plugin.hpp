@@ -45,6 +45,11 @@ namespace graphene { namespace plugins { namespace operation_history {
     DEFINE_API_ARGS(get_ops_in_block, msg_pack, std::vector<applied_operation>)
     DEFINE_API_ARGS(get_transaction,  msg_pack, annotated_signed_transaction)
 
+    /**
+     *  Adds indexes of the plugin to the database, tools which read the shared memory file call it too
+     */
+    void register_indexes(graphene::chain::database &db);
+
     /**
      *  This plugin is designed to track operations so that one node
      *  doesn't need to hold the full operation history in memory.
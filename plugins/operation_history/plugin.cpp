@@ -178,6 +178,10 @@ namespace graphene { namespace plugins { namespace operation_history {
         cfg.add(cli);
     }
 
+    void register_indexes(graphene::chain::database &db) {
+        graphene::chain::add_plugin_index<operation_index>(db);
+    }
+
     void plugin::plugin_initialize(const boost::program_options::variables_map& options) {
         ilog("operation_history plugin: plugin_initialize() begin");
 
@@ -187,7 +191,7 @@ namespace graphene { namespace plugins { namespace operation_history {
             pimpl->on_operation(note);
         });
 
-        graphene::chain::add_plugin_index<operation_index>(pimpl->database);
+        register_indexes(pimpl->database);
 
         auto split_list = [&](const std::vector<std::string>& ops_list) {
             for (const auto& raw: ops_list) {
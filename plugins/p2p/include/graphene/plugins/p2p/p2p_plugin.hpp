@@ -43,6 +43,9 @@ namespace graphene {
 
                 void set_block_production(bool producing_blocks);
 
+                /// bandwidth, compression and per message type traffic, in total and by peer
+                fc::variant_object get_network_usage_stats() const;
+
             private:
                 std::unique_ptr<detail::p2p_plugin_impl> my;
             };
@@ -2,6 +2,7 @@
 
 #include <graphene/network/node.hpp>
 #include <graphene/network/exceptions.hpp>
+#include <graphene/network/message_oriented_connection.hpp>
 
 #include <graphene/chain/database_exceptions.hpp>
 
@@ -61,6 +62,12 @@ namespace graphene {
 
                     virtual message get_item(const item_id &) override;
 
+                    virtual std::vector<char> get_serialized_block(const item_hash_t &) override;
+
+                    virtual fc::optional<signed_block_header> get_block_header(const item_hash_t &) override;
+
+                    virtual std::vector<std::vector<char>> get_serialized_block_range(uint32_t, uint32_t, uint32_t) override;
+
                     virtual std::vector<item_hash_t> get_blockchain_synopsis(const item_hash_t &, uint32_t) override;
 
                     virtual void sync_status(uint32_t, uint32_t) override;
@@ -88,6 +95,9 @@ namespace graphene {
                     vector<fc::ip::endpoint> seeds;
                     string user_agent;
                     uint32_t max_connections = 0;
+                    uint32_t read_threads = 0;
+                    fc::optional<uint32_t> compression_threshold;
+                    fc::optional<uint32_t> transaction_advertisement_interval;
                     bool force_validate = false;
                     bool block_producer = false;
 
@@ -246,6 +256,49 @@ namespace graphene {
                     } FC_CAPTURE_AND_RETHROW((id))
                 }
 
+                std::vector<char> p2p_plugin_impl::get_serialized_block(const item_hash_t &block_id) {
+                    try {
+                        // irreversible blocks are read from the block log without the database lock,
+                        // reversible ones are packed once by the fork database, others come from get_item()
+                        const auto &block_log = chain.db().get_block_log();
+                        uint32_t block_num = block_header::num_from_id(block_id);
+                        if (block_id != block_id_type() && block_log.read_block_id_by_num(block_num) == block_id) {
+                            return block_log.read_serialized_block_by_num(block_num);
+                        }
+                        return chain.db().with_weak_read_lock([&]() {
+                            return chain.db().fetch_serialized_reversible_block(block_id);
+                        });
+                    } FC_CAPTURE_AND_RETHROW((block_id))
+                }
+
+                fc::optional<signed_block_header> p2p_plugin_impl::get_block_header(const item_hash_t &block_id) {
+                    try {
+                        // the same sources as get_serialized_block(), but only the header is read
+                        const auto &block_log = chain.db().get_block_log();
+                        uint32_t block_num = block_header::num_from_id(block_id);
+                        if (block_id != block_id_type() && block_log.read_block_id_by_num(block_num) == block_id) {
+                            return block_log.read_block_header_by_num(block_num);
+                        }
+                        return chain.db().with_weak_read_lock([&]() {
+                            // a reversible block is already in memory in the fork database
+                            fc::optional<signed_block_header> result;
+                            auto block = chain.db().fetch_shared_block_by_id(block_id);
+                            if (block) {
+                                result = signed_block_header(*block);
+                            }
+                            return result;
+                        });
+                    } FC_CAPTURE_AND_RETHROW((block_id))
+                }
+
+                std::vector<std::vector<char>> p2p_plugin_impl::get_serialized_block_range(
+                        uint32_t first_block_num, uint32_t count, uint32_t max_total_size) {
+                    try {
+                        // only irreversible blocks are in the block log, it has its own lock
+                        return chain.db().get_block_log().read_serialized_blocks(first_block_num, count, max_total_size);
+                    } FC_CAPTURE_AND_RETHROW((first_block_num)(count)(max_total_size))
+                }
+
                 chain_id_type p2p_plugin_impl::get_chain_id() const {
                     return CHAIN_ID;
                 }
@@ -383,9 +436,9 @@ namespace graphene {
                 fc::time_point_sec p2p_plugin_impl::get_block_time(const item_hash_t &block_id) {
                     try {
                         return chain.db().with_weak_read_lock([&]() {
-                            auto opt_block = chain.db().fetch_block_by_id(block_id);
-                            if (opt_block.valid()) {
-                                return opt_block->timestamp;
+                            auto block = chain.db().fetch_shared_block_by_id(block_id);
+                            if (block) {
+                                return block->timestamp;
                             }
                             return fc::time_point_sec::min();
                         });
@@ -440,6 +493,12 @@ namespace graphene {
                         "The local IP address and port to listen for incoming connections.")
                     ("p2p-max-connections", boost::program_options::value<uint32_t>(),
                         "Maxmimum number of incoming connections on P2P endpoint.")
+                    ("p2p-compression-threshold", boost::program_options::value<uint32_t>(),
+                        "Blocks and transactions smaller than this are sent to peers uncompressed, 0 disables compression.")
+                    ("p2p-transaction-advertisement-interval", boost::program_options::value<uint32_t>(),
+                        "Milliseconds new transactions are collected before advertising them to peers, 0 advertises them at once.")
+                    ("p2p-read-threads", boost::program_options::value<uint32_t>()->default_value(2),
+                        "Number of threads which decrypt and unpack large incoming P2P messages, 0 to do it in the P2P thread.")
                     ("seed-node", boost::program_options::value<vector<string>>()->composing(),
                         "The IP address and port of a remote peer to sync with. Deprecated in favor of p2p-seed-node.")
                     ("p2p-seed-node", boost::program_options::value<vector<string>>()->composing(),
@@ -464,6 +523,16 @@ namespace graphene {
                     my->max_connections = options.at("p2p-max-connections").as<uint32_t>();
                 }
 
+                if (options.count("p2p-compression-threshold")) {
+                    my->compression_threshold = options.at("p2p-compression-threshold").as<uint32_t>();
+                }
+
+                if (options.count("p2p-transaction-advertisement-interval")) {
+                    my->transaction_advertisement_interval = options.at("p2p-transaction-advertisement-interval").as<uint32_t>();
+                }
+
+                my->read_threads = options.at("p2p-read-threads").as<uint32_t>();
+
                 if (options.count("seed-node") || options.count("p2p-seed-node")) {
                     vector<string> seeds;
                     if (options.count("seed-node")) {
@@ -499,6 +568,7 @@ namespace graphene {
             }
 
             void p2p_plugin::plugin_startup() {
+                graphene::network::message_oriented_connection::set_read_worker_thread_count(my->read_threads);
                 my->p2p_thread.async([this] {
                     my->node.reset(new graphene::network::node(my->user_agent));
                     my->node->load_configuration(app().data_dir() / "p2p");
@@ -522,6 +592,20 @@ namespace graphene {
                         my->node->set_advanced_node_parameters(node_param);
                     }
 
+                    if (my->compression_threshold) {
+                        ilog("Setting p2p compression threshold to ${n}", ("n", *my->compression_threshold));
+                        fc::variant_object node_param = fc::variant_object("message_compression_threshold",
+                                                                           fc::variant(*my->compression_threshold));
+                        my->node->set_advanced_node_parameters(node_param);
+                    }
+
+                    if (my->transaction_advertisement_interval) {
+                        ilog("Setting p2p transaction advertisement interval to ${n} ms", ("n", *my->transaction_advertisement_interval));
+                        fc::variant_object node_param = fc::variant_object("transaction_advertisement_interval_ms",
+                                                                           fc::variant(*my->transaction_advertisement_interval));
+                        my->node->set_advanced_node_parameters(node_param);
+                    }
+
                     my->node->listen_to_p2p_network();
                     my->node->connect_to_p2p_network();
                     block_id_type block_id;
@@ -540,6 +624,7 @@ namespace graphene {
                 my->node->close();
                 my->p2p_thread.quit();
                 my->node.reset();
+                graphene::network::message_oriented_connection::set_read_worker_thread_count(0);
             }
 
             void p2p_plugin::broadcast_block(const protocol::signed_block &block) {
@@ -556,6 +641,10 @@ namespace graphene {
                 my->block_producer = producing_blocks;
             }
 
+            fc::variant_object p2p_plugin::get_network_usage_stats() const {
+                return my->node->network_get_usage_stats();
+            }
+
         }
     }
 } // namespace graphene::plugins::p2p
@@ -25,8 +25,23 @@ namespace graphene {
             //     vector <message_api_obj> outbox;
             // };
 
-            DEFINE_API_ARGS(get_inbox,  json_rpc::msg_pack, vector <message_api_obj>)
-            DEFINE_API_ARGS(get_outbox, json_rpc::msg_pack, vector <message_api_obj>)
+            /**
+             *  Position of the last message of a page, the next page starts right after it
+             */
+            struct message_cursor {
+                time_point_sec receive_time;
+                message_id_type id;
+            };
+
+            DEFINE_API_ARGS(get_inbox,       json_rpc::msg_pack, vector <message_api_obj>)
+            DEFINE_API_ARGS(get_outbox,      json_rpc::msg_pack, vector <message_api_obj>)
+            DEFINE_API_ARGS(get_inbox_page,  json_rpc::msg_pack, vector <message_api_obj>)
+            DEFINE_API_ARGS(get_outbox_page, json_rpc::msg_pack, vector <message_api_obj>)
+
+            /**
+             *  Adds indexes of the plugin to the database, tools which read the shared memory file call it too
+             */
+            void register_indexes(graphene::chain::database &db);
 
             /**
              *   This plugin scans the blockchain for custom operations containing a valid message and authorized
@@ -63,7 +78,21 @@ namespace graphene {
                     return name;
                 }
 
-                DECLARE_API((get_inbox)(get_outbox))
+                DECLARE_API(
+                    (get_inbox)
+                    (get_outbox)
+
+                    /**
+                     *  Same as get_inbox/get_outbox, but pages are addressed by the cursor of the last message
+                     *  of the previous page (null for the first page) instead of an offset,
+                     *  so each page costs one index lookup regardless of its depth
+                     *  @param account receiver (inbox) or sender (outbox)
+                     *  @param start_after cursor {receive_time, id} of the last received message or null
+                     *  @param limit maximum number of messages -- must not exceed 100
+                     */
+                    (get_inbox_page)
+                    (get_outbox_page)
+                )
 
 
             private:
@@ -80,6 +109,8 @@ FC_REFLECT((graphene::plugins::private_message::message_body), (thread_start)(su
 FC_REFLECT((graphene::plugins::private_message::message_object), (id)(from)(to)(from_memo_key)(to_memo_key)(sent_time)(receive_time)(checksum)(encrypted_message));
 CHAINBASE_SET_INDEX_TYPE(graphene::plugins::private_message::message_object, graphene::plugins::private_message::message_index);
 
+FC_REFLECT((graphene::plugins::private_message::message_cursor), (receive_time)(id));
+
 FC_REFLECT((graphene::plugins::private_message::message_api_obj), (id)(from)(to)(from_memo_key)(to_memo_key)(sent_time)(receive_time)(checksum)(encrypted_message));
 
 FC_REFLECT_DERIVED((graphene::plugins::private_message::extended_message_object), ((graphene::plugins::private_message::message_api_obj)), (message));
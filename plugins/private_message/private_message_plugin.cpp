@@ -46,6 +46,11 @@ namespace graphene {
 
                 vector <message_api_obj> get_outbox(const std::string& from, time_point newest, uint16_t limit, std::uint64_t offset) const;
 
+                template<typename Tag>
+                vector <message_api_obj> get_messages_page(
+                        account_name_type message_object::*owner, const std::string& account,
+                        const optional <message_cursor>& start_after, uint16_t limit) const;
+
 
                 ~private_message_plugin_impl() {};
 
@@ -104,6 +109,31 @@ namespace graphene {
                 return result;
             }
 
+            template<typename Tag>
+            vector <message_api_obj> private_message_plugin::private_message_plugin_impl::get_messages_page(
+                    account_name_type message_object::*owner, const std::string& account,
+                    const optional <message_cursor>& start_after, uint16_t limit) const {
+                FC_ASSERT(limit <= 100);
+
+                vector <message_api_obj> result;
+                result.reserve(limit);
+
+                const auto &idx = _db.get_index<message_index>().indices().get<Tag>();
+
+                // messages are ordered by (account, receive_time desc, id), so the cursor is a direct key
+                auto itr = start_after.valid()
+                           ? idx.upper_bound(std::make_tuple(account, start_after->receive_time, start_after->id))
+                           : idx.lower_bound(std::make_tuple(account));
+
+                while (itr != idx.end() && limit && (*itr).*owner == account) {
+                    result.push_back(*itr);
+                    ++itr;
+                    --limit;
+                }
+
+                return result;
+            }
+
             void private_message_evaluator::do_apply(const private_message_operation &pm) {
                 database &d = db();
 
@@ -153,11 +183,15 @@ namespace graphene {
                 cfg.add(cli);
             }
 
+            void register_indexes(graphene::chain::database &db) {
+                add_plugin_index<message_index>(db);
+            }
+
             void private_message_plugin::plugin_initialize(const boost::program_options::variables_map &options) {
                 ilog("Intializing private message plugin");
                 my.reset(new private_message_plugin::private_message_plugin_impl(*this));
 
-                add_plugin_index<message_index>(my->_db);
+                register_indexes(my->_db);
 
                 typedef pair <string, string> pairstring;
                 LOAD_VALUE_SET(options, "pm-accounts", my->_tracked_accounts, pairstring);
@@ -199,6 +233,26 @@ namespace graphene {
                     return my->get_outbox(from, newest, limit, offset);
                 });
             }
+
+            DEFINE_API(private_message_plugin, get_inbox_page) {
+                auto to = args.args->at(0).as<std::string>();
+                auto start_after = args.args->at(1).as<optional<message_cursor>>();
+                auto limit = args.args->at(2).as<uint16_t>();
+                auto &db = my->_db;
+                return db.with_weak_read_lock([&]() {
+                    return my->get_messages_page<by_to_date>(&message_object::to, to, start_after, limit);
+                });
+            }
+
+            DEFINE_API(private_message_plugin, get_outbox_page) {
+                auto from = args.args->at(0).as<std::string>();
+                auto start_after = args.args->at(1).as<optional<message_cursor>>();
+                auto limit = args.args->at(2).as<uint16_t>();
+                auto &db = my->_db;
+                return db.with_weak_read_lock([&]() {
+                    return my->get_messages_page<by_from_date>(&message_object::from, from, start_after, limit);
+                });
+            }
         }
     }
 } // graphene::plugins::private_message
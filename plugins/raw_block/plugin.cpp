@@ -27,8 +27,8 @@ get_raw_block_r plugin::plugin_impl::get_raw_block(uint32_t block_num) {
     get_raw_block_r result;
     const auto &db = database();
 
-    auto block = db.fetch_block_by_number(block_num);
-    if (!block.valid()) {
+    auto block = db.fetch_shared_block_by_number(block_num);
+    if (!block) {
         return result;
     }
     std::vector<char> serialized_block = fc::raw::pack(*block);
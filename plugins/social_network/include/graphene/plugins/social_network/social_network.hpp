@@ -23,6 +23,7 @@ namespace graphene { namespace plugins { namespace social_network {
     DEFINE_API_ARGS(get_content,                msg_pack, discussion)
     DEFINE_API_ARGS(get_content_replies,        msg_pack, std::vector<discussion>)
     DEFINE_API_ARGS(get_all_content_replies,    msg_pack, std::vector<discussion>)
+    DEFINE_API_ARGS(get_content_replies_tree,   msg_pack, std::vector<discussion>)
     DEFINE_API_ARGS(get_account_votes,          msg_pack, std::vector<account_vote>)
     DEFINE_API_ARGS(get_active_votes,           msg_pack, std::vector<vote_state>)
     DEFINE_API_ARGS(get_replies_by_last_update, msg_pack, std::vector<discussion>)
@@ -44,6 +45,16 @@ namespace graphene { namespace plugins { namespace social_network {
             (get_content)
             (get_content_replies)
             (get_all_content_replies)
+            /**
+             *  Bounded variant of get_all_content_replies
+             *  @param author author of the content whose replies are returned
+             *  @param permlink permlink of the content
+             *  @param depth maximum depth of replies relative to the content, unlimited by default
+             *  @param limit maximum number of replies -- must not exceed 1000, 100 by default
+             *  @param vote_limit number of active votes for each reply, votes are skipped by default
+             *  @return replies in breadth-first order, replies field lists only the returned children
+             */
+            (get_content_replies_tree)
             (get_account_votes)
             (get_active_votes)
             (get_replies_by_last_update)
@@ -9,6 +9,10 @@
 #include <graphene/chain/invite_objects.hpp>
 #include <graphene/api/invite_api_object.hpp>
 
+#include <mutex>
+#include <algorithm>
+#include <list>
+
 // These visitors creates additional tables, we don't really need them in LOW_MEM mode
 #include <graphene/plugins/tags/plugin.hpp>
 
@@ -33,9 +37,30 @@
 #  define DEFAULT_VOTE_LIMIT 10000
 #endif
 
+#ifndef DEFAULT_REPLIES_TREE_LIMIT
+#  define DEFAULT_REPLIES_TREE_LIMIT 100
+#endif
+
 namespace graphene { namespace plugins { namespace social_network {
     using graphene::api::discussion_helper;
 
+    /**
+     *  Shape of a whole thread: contents of the root in id order with links to their replies.
+     *  It is valid while the root has the same children counter and active time,
+     *  because any reply or removal in the thread updates both of them.
+     *  Ids of popped contents are reused on a fork switch, so the cache is cleared then.
+     */
+    struct thread_skeleton {
+        struct node {
+            content_object::id_type id;
+            std::vector<uint32_t> replies;
+        };
+
+        uint32_t children = 0;
+        time_point_sec active;
+        std::vector<node> nodes;
+    };
+
     struct social_network::impl final {
         impl(): database_(appbase::app().get_plugin<chain::plugin>().db()) {
             helper = std::make_unique<discussion_helper>(database_);
@@ -68,6 +93,15 @@ namespace graphene { namespace plugins { namespace social_network {
             const std::string& author, const std::string& permlink, uint32_t vote_limit
         ) const;
 
+        std::shared_ptr<const thread_skeleton> get_thread_skeleton(const content_object& root);
+
+        std::vector<discussion> get_content_replies_tree(
+            const std::string& author, const std::string& permlink,
+            uint32_t depth, uint32_t limit, uint32_t vote_limit
+        );
+
+        uint32_t thread_cache_size = 100;
+
         std::vector<discussion> get_replies_by_last_update(
             account_name_type start_parent_author, std::string start_permlink,
             uint32_t limit, uint32_t vote_limit
@@ -80,6 +114,26 @@ namespace graphene { namespace plugins { namespace social_network {
     private:
         graphene::chain::database& database_;
         std::unique_ptr<discussion_helper> helper;
+
+        struct thread_cache_entry {
+            std::shared_ptr<const thread_skeleton> skeleton;
+            /// position of the root in thread_cache_order
+            std::list<content_object::id_type>::iterator order_itr;
+        };
+
+        std::mutex thread_cache_mutex;
+        std::map<content_object::id_type, thread_cache_entry> thread_cache;
+        /// roots of cached threads from the most recently used to the least recently used
+        std::list<content_object::id_type> thread_cache_order;
+        /// the head block which the cached skeletons were built on or carried over to
+        block_id_type thread_cache_block_id;
+
+    public:
+        void on_applied_block(const signed_block& block);
+
+    private:
+        /// clear the cache if the head block isn't a descendant of the last seen one, requires the cache mutex
+        void check_thread_cache_fork(const block_id_type& previous, const block_id_type& head);
     };
 
 
@@ -113,10 +167,21 @@ namespace graphene { namespace plugins { namespace social_network {
         boost::program_options::options_description&,
         boost::program_options::options_description& config_file_options
     ) {
+        config_file_options.add_options()
+            ("social-network-thread-cache-size", boost::program_options::value<uint32_t>()->default_value(100),
+                "Number of threads whose reply tree shape is cached for get_content_replies_tree");
     }
 
     void social_network::plugin_initialize(const boost::program_options::variables_map& options) {
         pimpl = std::make_unique<impl>();
+        if (options.count("social-network-thread-cache-size")) {
+            pimpl->thread_cache_size = options["social-network-thread-cache-size"].as<uint32_t>();
+        }
+#ifndef IS_LOW_MEM
+        pimpl->database().applied_block.connect([this](const signed_block& block) {
+            pimpl->on_applied_block(block);
+        });
+#endif
         JSON_RPC_REGISTER_API(name());
     }
 
@@ -183,6 +248,158 @@ namespace graphene { namespace plugins { namespace social_network {
         });
     }
 
+    void social_network::impl::check_thread_cache_fork(const block_id_type& previous, const block_id_type& head) {
+        if (previous != thread_cache_block_id) {
+            thread_cache.clear();
+            thread_cache_order.clear();
+        }
+        thread_cache_block_id = head;
+    }
+
+    void social_network::impl::on_applied_block(const signed_block& block) {
+        std::lock_guard<std::mutex> lock(thread_cache_mutex);
+        check_thread_cache_fork(block.previous, database().head_block_id());
+    }
+
+    std::shared_ptr<const thread_skeleton> social_network::impl::get_thread_skeleton(const content_object& root) {
+#ifndef IS_LOW_MEM
+        const auto head_block_id = database().head_block_id();
+        {
+            std::lock_guard<std::mutex> lock(thread_cache_mutex);
+            // blocks popped without a new one applied yet
+            check_thread_cache_fork(head_block_id, head_block_id);
+            auto itr = thread_cache.find(root.id);
+            if (itr != thread_cache.end() &&
+                itr->second.skeleton->children == root.children && itr->second.skeleton->active == root.active
+            ) {
+                thread_cache_order.splice(thread_cache_order.begin(), thread_cache_order, itr->second.order_itr);
+                return itr->second.skeleton;
+            }
+        }
+#endif
+
+        auto result = std::make_shared<thread_skeleton>();
+        result->children = root.children;
+        result->active = root.active;
+        result->nodes.reserve(root.children + 1);
+
+        // the thread is walked by root id, so nodes are in id order and parents are created before their replies:
+        // the node of the parent id is found by a binary search over nodes already seen
+        auto& nodes = result->nodes;
+        const auto& idx = database().get_index<content_index>().indices().get<by_root>();
+        for (auto itr = idx.lower_bound(root.id); itr != idx.end() && itr->root_content == root.id; ++itr) {
+            auto position = static_cast<uint32_t>(nodes.size());
+            if (itr->id != root.id) {
+                auto parent_node = std::lower_bound(nodes.begin(), nodes.end(), itr->parent_content,
+                    [](const thread_skeleton::node& n, const content_object::id_type& id) {
+                        return n.id < id;
+                    });
+                if (parent_node != nodes.end() && parent_node->id == itr->parent_content) {
+                    parent_node->replies.push_back(position);
+                }
+            }
+            nodes.push_back({itr->id, {}});
+        }
+
+#ifndef IS_LOW_MEM
+        if (thread_cache_size > 0) {
+            std::lock_guard<std::mutex> lock(thread_cache_mutex);
+            if (thread_cache_block_id != head_block_id) {
+                // the head was switched while the skeleton was built
+                return result;
+            }
+            auto itr = thread_cache.find(root.id);
+            if (itr == thread_cache.end()) {
+                if (thread_cache.size() >= thread_cache_size) {
+                    thread_cache.erase(thread_cache_order.back());
+                    thread_cache_order.pop_back();
+                }
+                itr = thread_cache.emplace(root.id, thread_cache_entry()).first;
+                itr->second.order_itr = thread_cache_order.insert(thread_cache_order.begin(), root.id);
+            } else {
+                thread_cache_order.splice(thread_cache_order.begin(), thread_cache_order, itr->second.order_itr);
+            }
+            itr->second.skeleton = result;
+        }
+#endif
+        return result;
+    }
+
+    std::vector<discussion> social_network::impl::get_content_replies_tree(
+        const std::string& author, const std::string& permlink,
+        uint32_t depth, uint32_t limit, uint32_t vote_limit
+    ) {
+        FC_ASSERT(limit <= 1000, "Cannot retrieve more than 1000 replies at a time.");
+
+        std::vector<discussion> result;
+        auto& db = database();
+        const auto* content = db.find_content(author, permlink);
+        if (content == nullptr || content->children == 0 || depth == 0 || limit == 0) {
+            return result;
+        }
+
+        const auto& root = db.get(content->root_content);
+        auto skeleton = get_thread_skeleton(root);
+        const auto& nodes = skeleton->nodes;
+
+        // nodes are in id order, so the start content is found by a binary search
+        auto start = std::lower_bound(nodes.begin(), nodes.end(), content->id,
+            [](const thread_skeleton::node& n, const content_object::id_type& id) {
+                return n.id < id;
+            });
+        if (start == nodes.end() || start->id != content->id) {
+            return result;
+        }
+
+        // breadth-first walk which stops at the depth and size bounds
+        std::vector<std::pair<uint32_t, uint32_t>> selected; // node position, depth
+        std::vector<uint32_t> result_position(nodes.size(), UINT32_MAX);
+        selected.emplace_back(static_cast<uint32_t>(start - nodes.begin()), 0);
+        for (std::size_t i = 0; i < selected.size() && selected.size() <= limit; ++i) {
+            auto node_depth = selected[i].second;
+            if (node_depth >= depth) {
+                continue;
+            }
+            for (auto reply : nodes[selected[i].first].replies) {
+                if (selected.size() > limit) {
+                    break;
+                }
+                result_position[reply] = static_cast<uint32_t>(selected.size() - 1);
+                selected.emplace_back(reply, node_depth + 1);
+            }
+        }
+
+        const discussion root_discussion = helper->create_discussion(root);
+        result.reserve(selected.size() - 1);
+        for (std::size_t i = 1; i < selected.size(); ++i) {
+            result.emplace_back(helper->get_thread_discussion(db.get(nodes[selected[i].first].id), root_discussion, vote_limit));
+        }
+
+        for (std::size_t i = 1; i < selected.size(); ++i) {
+            auto& d = result[i - 1];
+            for (auto reply : nodes[selected[i].first].replies) {
+                if (result_position[reply] != UINT32_MAX) {
+                    const auto& r = result[result_position[reply]];
+                    d.replies.push_back(r.author + "/" + r.permlink);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    DEFINE_API(social_network, get_content_replies_tree) {
+        CHECK_ARG_MIN_SIZE(2, 5)
+        auto author = args.args->at(0).as<string>();
+        auto permlink = args.args->at(1).as<string>();
+        auto depth = GET_OPTIONAL_ARG(2, uint32_t, UINT32_MAX);
+        auto limit = GET_OPTIONAL_ARG(3, uint32_t, DEFAULT_REPLIES_TREE_LIMIT);
+        auto vote_limit = GET_OPTIONAL_ARG(4, uint32_t, 0);
+        return pimpl->database().with_weak_read_lock([&]() {
+            return pimpl->get_content_replies_tree(author, permlink, depth, limit, vote_limit);
+        });
+    }
+
     DEFINE_API(social_network, get_account_votes) {
         CHECK_ARG_MIN_SIZE(1, 3)
         account_name_type voter = args.args->at(0).as<account_name_type>();
@@ -220,10 +437,9 @@ namespace graphene { namespace plugins { namespace social_network {
     }
 
     discussion social_network::impl::get_content(std::string author, std::string permlink, uint32_t limit) const {
-        const auto& by_permlink_idx = database().get_index<content_index>().indices().get<by_permlink>();
-        auto itr = by_permlink_idx.find(std::make_tuple(author, permlink));
-        if (itr != by_permlink_idx.end()) {
-            return get_discussion(*itr, limit);
+        const auto* content = database().find_content(author, permlink);
+        if (content != nullptr) {
+            return get_discussion(*content, limit);
         }
         return discussion();
     }
@@ -33,6 +33,11 @@ namespace graphene { namespace plugins { namespace tags {
     DEFINE_API_ARGS(get_discussions_by_author_before_date, msg_pack, std::vector<discussion>)
     DEFINE_API_ARGS(get_languages,                         msg_pack, get_languages_result);
 
+    /**
+     *  Adds indexes of the plugin to the database, tools which read the shared memory file call it too
+     */
+    void register_indexes(graphene::chain::database &db);
+
     class tags_plugin final: public appbase::plugin<tags_plugin> {
     public:
         APPBASE_PLUGIN_REQUIRES(
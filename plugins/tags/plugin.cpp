@@ -205,6 +205,15 @@ namespace graphene { namespace plugins { namespace tags {
         cfg.add(cli);
     }
 
+    void register_indexes(graphene::chain::database &db) {
+#ifndef IS_LOW_MEM
+        add_plugin_index<tags::tag_index>(db);
+        add_plugin_index<tags::tag_stats_index>(db);
+        add_plugin_index<tags::author_tag_stats_index>(db);
+        add_plugin_index<tags::language_index>(db);
+#endif
+    }
+
     void tags_plugin::plugin_initialize(const boost::program_options::variables_map& options) {
         pimpl.reset(new impl());
 // Disable index creation for tag visitor
@@ -213,10 +222,7 @@ namespace graphene { namespace plugins { namespace tags {
         db.post_apply_operation.connect([&](const operation_notification& note) {
             pimpl->on_operation(note);
         });
-        add_plugin_index<tags::tag_index>(db);
-        add_plugin_index<tags::tag_stats_index>(db);
-        add_plugin_index<tags::author_tag_stats_index>(db);
-        add_plugin_index<tags::language_index>(db);
+        register_indexes(db);
 #endif
 
         if (options.count("tags-content-lifespan")) {
@@ -645,12 +651,11 @@ namespace graphene { namespace plugins { namespace tags {
             }
 
             if (!!query.start_permlink) {
-                const auto &lidx = db.get_index<content_index>().indices().get<by_permlink>();
-                auto litr = lidx.find(std::make_tuple(*query.start_author, *query.start_permlink));
-                if (litr == lidx.end()) {
+                const auto *start = db.find_content(*query.start_author, *query.start_permlink);
+                if (start == nullptr) {
                     return result;
                 }
-                itr = idx.iterator_to(*litr);
+                itr = idx.iterator_to(*start);
             }
 
             if (!pimpl->filter_query(query)) {
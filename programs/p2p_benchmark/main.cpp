@@ -0,0 +1,613 @@
+/**
+ *  Headless benchmark of the p2p layer: runs a number of in-process nodes connected over loopback,
+ *  floods them with transactions, produces blocks on the first node, then lets a fresh node sync the
+ *  whole chain, and prints propagation latencies, traffic and sync speed as JSON.
+ *
+ *  Nodes use the real graphene::network::node with a minimal in-memory chain behind it, so the
+ *  results reflect the network code only.  The topology and all generated transactions and blocks
+ *  depend on --seed alone; timings of course still depend on the machine.
+ */
+#include <graphene/network/node.hpp>
+#include <graphene/network/message_oriented_connection.hpp>
+#include <graphene/network/exceptions.hpp>
+
+#include <graphene/protocol/protocol.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/log/logger.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/smart_ref_impl.hpp>
+#include <fc/variant_object.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace bpo = boost::program_options;
+
+using namespace graphene::network;
+using graphene::protocol::block_id_type;
+using graphene::protocol::block_header;
+using graphene::protocol::signed_block;
+using graphene::protocol::signed_transaction;
+using graphene::protocol::custom_operation;
+
+/**
+ *  Records when each item was first broadcast and how long it took to reach every other node
+ */
+struct propagation_tracker {
+    std::mutex mutex;
+    std::map<item_hash_t, fc::time_point> origin_times;
+    std::vector<int64_t> block_latencies;
+    std::vector<int64_t> transaction_latencies;
+
+    void originated(const item_hash_t &item_hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        origin_times[item_hash] = fc::time_point::now();
+    }
+
+    void received(uint32_t item_type, const item_hash_t &item_hash) {
+        fc::time_point now = fc::time_point::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        auto itr = origin_times.find(item_hash);
+        if (itr == origin_times.end()) {
+            return;
+        }
+        int64_t latency = (now - itr->second).count();
+        if (item_type == block_message_type) {
+            block_latencies.push_back(latency);
+        } else {
+            transaction_latencies.push_back(latency);
+        }
+    }
+};
+
+/**
+ *  Minimal in-memory chain: blocks are accepted if they link to the head, transactions are just stored
+ */
+class benchmark_node_delegate : public node_delegate {
+public:
+    benchmark_node_delegate(propagation_tracker &tracker, fc::time_point_sec genesis_time)
+            : _tracker(tracker), _genesis_time(genesis_time) {
+    }
+
+    void add_block(const signed_block &block) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        FC_ASSERT(block.previous == head_id(), "block does not link to the head block");
+        _block_ids.push_back(block.id());
+        _blocks[_block_ids.back()] = block;
+    }
+
+    void add_transaction(const item_hash_t &message_id, const signed_transaction &trx) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _transactions[message_id] = trx;
+    }
+
+    uint32_t head_block_num() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _block_ids.size();
+    }
+
+    size_t transaction_count() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _transactions.size();
+    }
+
+    bool has_item(const item_id &id) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (id.item_type == block_message_type) {
+            return _blocks.count(id.item_hash) != 0;
+        }
+        return _transactions.count(id.item_hash) != 0;
+    }
+
+    bool handle_block(const block_message &blk_msg, bool sync_mode, std::vector<fc::uint160_t> &) override {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_blocks.count(blk_msg.block_id)) {
+                return false;
+            }
+            if (blk_msg.block.previous != head_id()) {
+                FC_THROW_EXCEPTION(unlinkable_block_exception, "block ${n} does not link to head block ${h}",
+                        ("n", blk_msg.block.block_num())("h", _block_ids.size()));
+            }
+            _block_ids.push_back(blk_msg.block_id);
+            _blocks[blk_msg.block_id] = blk_msg.block;
+        }
+        if (!sync_mode) {
+            _tracker.received(block_message_type, blk_msg.block_id);
+        }
+        return false;
+    }
+
+    void handle_transaction(const trx_message &trx_msg) override {
+        item_hash_t message_id = message(trx_msg).id();
+        add_transaction(message_id, trx_msg.trx);
+        _tracker.received(trx_message_type, message_id);
+    }
+
+    void handle_message(const message &) override {
+        FC_THROW("Invalid Message Type");
+    }
+
+    std::vector<item_hash_t> get_block_ids(const std::vector<item_hash_t> &blockchain_synopsis,
+            uint32_t &remaining_item_count, uint32_t limit) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<item_hash_t> result;
+        remaining_item_count = 0;
+        if (_block_ids.empty()) {
+            return result;
+        }
+
+        uint32_t last_known_block_num = 0;
+        if (!blockchain_synopsis.empty() &&
+            !(blockchain_synopsis.size() == 1 && blockchain_synopsis[0] == block_id_type())) {
+            bool found_a_block_in_synopsis = false;
+            for (auto itr = blockchain_synopsis.rbegin(); itr != blockchain_synopsis.rend(); ++itr) {
+                if (*itr == block_id_type() || is_included_block(*itr)) {
+                    last_known_block_num = block_header::num_from_id(*itr);
+                    found_a_block_in_synopsis = true;
+                    break;
+                }
+            }
+            if (!found_a_block_in_synopsis) {
+                FC_THROW_EXCEPTION(peer_is_on_an_unreachable_fork, "Unable to provide a list of blocks starting at any of the blocks in peer's synopsis");
+            }
+        }
+
+        for (uint32_t num = last_known_block_num; num <= _block_ids.size() && result.size() < limit; ++num) {
+            if (num > 0) {
+                result.push_back(_block_ids[num - 1]);
+            }
+        }
+        if (!result.empty() && block_header::num_from_id(result.back()) < _block_ids.size()) {
+            remaining_item_count = _block_ids.size() - block_header::num_from_id(result.back());
+        }
+        return result;
+    }
+
+    message get_item(const item_id &id) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (id.item_type == block_message_type) {
+            auto itr = _blocks.find(id.item_hash);
+            if (itr == _blocks.end()) {
+                FC_THROW_EXCEPTION(fc::key_not_found_exception, "unknown block ${id}", ("id", id.item_hash));
+            }
+            return block_message(itr->second);
+        }
+        auto itr = _transactions.find(id.item_hash);
+        if (itr == _transactions.end()) {
+            FC_THROW_EXCEPTION(fc::key_not_found_exception, "unknown transaction ${id}", ("id", id.item_hash));
+        }
+        return trx_message(itr->second);
+    }
+
+    // blocks are served packed like the p2p plugin serves them from the block log,
+    // so syncing goes through the same range requests as a real node
+    std::vector<char> get_serialized_block(const item_hash_t &block_id) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto itr = _blocks.find(block_id);
+        if (itr == _blocks.end()) {
+            return std::vector<char>();
+        }
+        return fc::raw::pack(itr->second);
+    }
+
+    fc::optional<graphene::protocol::signed_block_header> get_block_header(const item_hash_t &block_id) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        fc::optional<graphene::protocol::signed_block_header> result;
+        auto itr = _blocks.find(block_id);
+        if (itr != _blocks.end()) {
+            result = graphene::protocol::signed_block_header(itr->second);
+        }
+        return result;
+    }
+
+    std::vector<std::vector<char>> get_serialized_block_range(uint32_t first_block_num, uint32_t count,
+            uint32_t max_total_size) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<std::vector<char>> result;
+        uint64_t total_size = 0;
+        for (uint32_t num = first_block_num; num > 0 && num <= _block_ids.size() && result.size() < count; ++num) {
+            std::vector<char> packed = fc::raw::pack(_blocks.at(_block_ids[num - 1]));
+            if (total_size + packed.size() > max_total_size) {
+                break;
+            }
+            total_size += packed.size();
+            result.push_back(std::move(packed));
+        }
+        return result;
+    }
+
+    std::vector<item_hash_t> get_blockchain_synopsis(const item_hash_t &reference_point,
+            uint32_t number_of_blocks_after_reference_point) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<item_hash_t> synopsis;
+        uint32_t high_block_num = _block_ids.size();
+        if (reference_point != item_hash_t()) {
+            FC_ASSERT(is_included_block(reference_point), "there are no forks in the benchmark");
+            high_block_num = block_header::num_from_id(reference_point);
+        }
+        if (high_block_num == 0) {
+            return synopsis;
+        }
+
+        uint32_t low_block_num = 1;
+        uint32_t true_high_block_num = high_block_num + number_of_blocks_after_reference_point;
+        do {
+            synopsis.push_back(_block_ids[low_block_num - 1]);
+            low_block_num += (true_high_block_num - low_block_num + 2) / 2;
+        } while (low_block_num <= high_block_num);
+        return synopsis;
+    }
+
+    void sync_status(uint32_t, uint32_t) override {
+    }
+
+    void connection_count_changed(uint32_t) override {
+    }
+
+    uint32_t get_block_number(const item_hash_t &block_id) override {
+        return block_header::num_from_id(block_id);
+    }
+
+    fc::time_point_sec get_block_time(const item_hash_t &block_id) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (block_id == item_hash_t()) {
+            return _genesis_time;
+        }
+        auto itr = _blocks.find(block_id);
+        if (itr == _blocks.end()) {
+            return fc::time_point_sec::min();
+        }
+        return itr->second.timestamp;
+    }
+
+    fc::time_point_sec get_blockchain_now() override {
+        return fc::time_point::now();
+    }
+
+    item_hash_t get_head_block_id() const override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return head_id();
+    }
+
+    uint32_t estimate_last_known_fork_from_git_revision_timestamp(uint32_t) const override {
+        return 0;
+    }
+
+    void error_encountered(const std::string &message, const fc::oexception &error) override {
+        elog("${message} ${error}", ("message", message)("error", error));
+    }
+
+private:
+    block_id_type head_id() const {
+        return _block_ids.empty() ? block_id_type() : _block_ids.back();
+    }
+
+    bool is_included_block(const block_id_type &block_id) const {
+        uint32_t block_num = block_header::num_from_id(block_id);
+        return block_num > 0 && block_num <= _block_ids.size() && _block_ids[block_num - 1] == block_id;
+    }
+
+    propagation_tracker &_tracker;
+    fc::time_point_sec _genesis_time;
+
+    mutable std::mutex _mutex;
+    std::vector<block_id_type> _block_ids;
+    std::map<block_id_type, signed_block> _blocks;
+    std::map<item_hash_t, signed_transaction> _transactions;
+};
+
+struct benchmark_node {
+    std::unique_ptr<fc::thread> thread;
+    std::unique_ptr<benchmark_node_delegate> delegate;
+    std::unique_ptr<node> p2p_node;
+    fc::ip::endpoint endpoint;
+    uint32_t expected_connections = 0;
+};
+
+static void start_node(benchmark_node &n, uint32_t index, const fc::path &data_dir, propagation_tracker &tracker,
+        fc::time_point_sec genesis_time, uint32_t max_connections) {
+    n.thread.reset(new fc::thread("p2p_benchmark_" + std::to_string(index)));
+    n.delegate.reset(new benchmark_node_delegate(tracker, genesis_time));
+    n.thread->async([&]() {
+        n.p2p_node.reset(new node("p2p_benchmark"));
+        n.p2p_node->load_configuration(data_dir / std::to_string(index));
+        n.p2p_node->set_node_delegate(n.delegate.get());
+        n.p2p_node->listen_on_endpoint(fc::ip::endpoint(fc::ip::address("127.0.0.1"), 0), false);
+        // keep the generated topology: peers don't learn about each other beyond it
+        n.p2p_node->disable_peer_advertising();
+        n.p2p_node->set_advanced_node_parameters(fc::mutable_variant_object()
+                ("desired_number_of_connections", 1)
+                ("maximum_number_of_connections", max_connections));
+        n.p2p_node->listen_to_p2p_network();
+        n.p2p_node->connect_to_p2p_network();
+        n.p2p_node->sync_from(item_id(block_message_type, block_id_type()), std::vector<uint32_t>());
+        n.endpoint = n.p2p_node->get_actual_listening_endpoint();
+    }, "start p2p_benchmark node").wait();
+}
+
+static void stop_node(benchmark_node &n) {
+    n.p2p_node->close();
+    n.thread->quit();
+    n.p2p_node.reset();
+}
+
+template<typename Predicate>
+static bool wait_until(Predicate predicate, fc::microseconds timeout) {
+    fc::time_point deadline = fc::time_point::now() + timeout;
+    while (!predicate()) {
+        if (fc::time_point::now() > deadline) {
+            return false;
+        }
+        fc::usleep(fc::milliseconds(10));
+    }
+    return true;
+}
+
+static uint64_t total_bytes_received(std::vector<benchmark_node> &nodes) {
+    uint64_t total = 0;
+    for (auto &n : nodes) {
+        for (const peer_status &peer : n.p2p_node->get_connected_peers()) {
+            total += peer.info["bytesrecv"].as_uint64();
+        }
+    }
+    return total;
+}
+
+/// latency percentiles in milliseconds
+static fc::mutable_variant_object latency_summary(std::vector<int64_t> latencies) {
+    fc::mutable_variant_object result;
+    result["samples"] = latencies.size();
+    if (latencies.empty()) {
+        return result;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](uint32_t p) {
+        return double(latencies[std::min<size_t>(latencies.size() - 1, latencies.size() * p / 100)]) / 1000;
+    };
+    result["p50_ms"] = percentile(50);
+    result["p90_ms"] = percentile(90);
+    result["p99_ms"] = percentile(99);
+    result["max_ms"] = double(latencies.back()) / 1000;
+    return result;
+}
+
+int main(int argc, char **argv) {
+    try {
+        bpo::options_description opts;
+        opts.add_options()
+                ("help,h", "Print this help message and exit.")
+                ("nodes", bpo::value<uint32_t>()->default_value(8), "Number of nodes in the network")
+                ("extra-connections", bpo::value<uint32_t>()->default_value(2), "Random connections per node on top of a ring")
+                ("transactions", bpo::value<uint32_t>()->default_value(1000), "Number of transactions to flood the network with")
+                ("transaction-size", bpo::value<uint32_t>()->default_value(200), "Payload bytes per transaction")
+                ("transaction-rate", bpo::value<uint32_t>()->default_value(500), "Transactions broadcast per second")
+                ("blocks", bpo::value<uint32_t>()->default_value(20), "Number of blocks to produce and relay")
+                ("block-transactions", bpo::value<uint32_t>()->default_value(50), "Transactions included in each block")
+                ("block-interval-ms", bpo::value<uint32_t>()->default_value(1000), "Milliseconds between produced blocks")
+                ("sync-blocks", bpo::value<uint32_t>()->default_value(2000), "Extra empty blocks the syncing node has to fetch")
+                ("read-threads", bpo::value<uint32_t>()->default_value(2), "Threads which decrypt and unpack large incoming messages")
+                ("seed", bpo::value<uint32_t>()->default_value(1), "Seed of the topology and of the generated transactions")
+                ("phase-timeout", bpo::value<uint32_t>()->default_value(120), "Seconds each phase may take before the run fails")
+                ("max-block-latency-ms", bpo::value<uint32_t>()->default_value(0), "Fail if p99 block propagation latency exceeds this, 0 to not check")
+                ("max-sync-seconds", bpo::value<uint32_t>()->default_value(0), "Fail if syncing takes longer than this, 0 to not check");
+
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(argc, argv, opts), options);
+        if (options.count("help")) {
+            std::cout << opts << "\n";
+            return 0;
+        }
+
+        const uint32_t node_count = std::max<uint32_t>(options.at("nodes").as<uint32_t>(), 2);
+        const uint32_t extra_connections = options.at("extra-connections").as<uint32_t>();
+        const uint32_t transaction_count = options.at("transactions").as<uint32_t>();
+        const uint32_t transaction_size = options.at("transaction-size").as<uint32_t>();
+        const uint32_t transaction_rate = std::max<uint32_t>(options.at("transaction-rate").as<uint32_t>(), 1);
+        const uint32_t block_count = options.at("blocks").as<uint32_t>();
+        const uint32_t block_transactions = options.at("block-transactions").as<uint32_t>();
+        const uint32_t block_interval_ms = options.at("block-interval-ms").as<uint32_t>();
+        const uint32_t sync_blocks = options.at("sync-blocks").as<uint32_t>();
+        const fc::microseconds phase_timeout = fc::seconds(options.at("phase-timeout").as<uint32_t>());
+        const uint32_t max_block_latency_ms = options.at("max-block-latency-ms").as<uint32_t>();
+        const uint32_t max_sync_seconds = options.at("max-sync-seconds").as<uint32_t>();
+
+        // the nodes log every message they handle, only keep what indicates a problem
+        fc::logger::get("default").set_log_level(fc::log_level::warn);
+
+        std::mt19937 rng(options.at("seed").as<uint32_t>());
+        fc::temp_directory data_dir;
+        propagation_tracker tracker;
+        bool success = true;
+        fc::mutable_variant_object report;
+
+        // blocks are stamped in the past so the nodes find any chain length plausible
+        const uint32_t total_blocks = block_count + sync_blocks;
+        const fc::time_point_sec genesis_time = fc::time_point_sec(fc::time_point::now()) -
+                                                (total_blocks + 1) * CHAIN_BLOCK_INTERVAL;
+
+        message_oriented_connection::set_read_worker_thread_count(options.at("read-threads").as<uint32_t>());
+
+        // a ring keeps the network connected, random chords shorten paths
+        // room for the syncing node, so references to the others stay valid when it's added
+        std::vector<benchmark_node> nodes;
+        nodes.reserve(node_count + 1);
+        nodes.resize(node_count);
+        std::set<std::pair<uint32_t, uint32_t>> connections;
+        for (uint32_t i = 0; i < node_count; ++i) {
+            uint32_t j = (i + 1) % node_count;
+            connections.insert(std::make_pair(std::min(i, j), std::max(i, j)));
+            for (uint32_t k = 0; k < extra_connections; ++k) {
+                j = rng() % node_count;
+                if (j != i) {
+                    connections.insert(std::make_pair(std::min(i, j), std::max(i, j)));
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < node_count; ++i) {
+            start_node(nodes[i], i, data_dir.path(), tracker, genesis_time, node_count + 1);
+        }
+        for (const auto &c : connections) {
+            ++nodes[c.first].expected_connections;
+            ++nodes[c.second].expected_connections;
+            nodes[c.first].p2p_node->connect_to_endpoint(nodes[c.second].endpoint);
+        }
+        bool connected = wait_until([&]() {
+            return std::all_of(nodes.begin(), nodes.end(), [](benchmark_node &n) {
+                return n.p2p_node->get_connection_count() >= n.expected_connections;
+            });
+        }, phase_timeout);
+        report["topology"] = fc::mutable_variant_object()
+                ("nodes", node_count)
+                ("connections", connections.size())
+                ("connected", connected);
+        success = success && connected;
+
+        // transaction flood, each transaction enters the network at a different node
+        std::vector<signed_transaction> transactions;
+        transactions.reserve(transaction_count);
+        for (uint32_t i = 0; i < transaction_count; ++i) {
+            std::string payload(transaction_size, ' ');
+            for (char &c : payload) {
+                c = "0123456789abcdef"[rng() % 16];
+            }
+            custom_operation op;
+            op.required_posting_auths.insert("p2p-benchmark");
+            op.id = "p2p_benchmark";
+            op.json = "\"" + payload + "\"";
+
+            signed_transaction trx;
+            trx.expiration = genesis_time + (total_blocks + 3600) * CHAIN_BLOCK_INTERVAL;
+            trx.operations.push_back(op);
+            transactions.push_back(trx);
+        }
+
+        uint64_t bytes_before = total_bytes_received(nodes);
+        fc::time_point phase_start = fc::time_point::now();
+        for (uint32_t i = 0; i < transaction_count; ++i) {
+            trx_message trx_msg(transactions[i]);
+            item_hash_t message_id = message(trx_msg).id();
+            benchmark_node &origin = nodes[i % node_count];
+            origin.delegate->add_transaction(message_id, transactions[i]);
+            tracker.originated(message_id);
+            origin.p2p_node->broadcast(trx_msg);
+            fc::usleep(fc::microseconds(1000000 / transaction_rate));
+        }
+        bool transactions_delivered = wait_until([&]() {
+            return std::all_of(nodes.begin(), nodes.end(), [&](benchmark_node &n) {
+                return n.delegate->transaction_count() >= transaction_count;
+            });
+        }, phase_timeout);
+        uint64_t transaction_bytes = total_bytes_received(nodes) - bytes_before;
+        {
+            std::lock_guard<std::mutex> lock(tracker.mutex);
+            report["transactions"] = fc::mutable_variant_object()
+                    ("count", transaction_count)
+                    ("delivered", transactions_delivered)
+                    ("seconds", double((fc::time_point::now() - phase_start).count()) / 1000000)
+                    ("latency", latency_summary(tracker.transaction_latencies))
+                    ("bytes_per_transaction", transaction_count ? transaction_bytes / transaction_count : 0);
+        }
+        success = success && transactions_delivered;
+
+        // block relay, the first node produces blocks which include the flooded transactions
+        auto make_block = [&](uint32_t block_num, const block_id_type &previous) {
+            signed_block block;
+            block.previous = previous;
+            block.timestamp = genesis_time + block_num * CHAIN_BLOCK_INTERVAL;
+            block.witness = "p2p-benchmark";
+            uint32_t first = (block_num - 1) * block_transactions;
+            for (uint32_t i = first; i < first + block_transactions && i < transactions.size(); ++i) {
+                block.transactions.push_back(transactions[i]);
+            }
+            return block;
+        };
+
+        benchmark_node &producer = nodes[0];
+        bytes_before = total_bytes_received(nodes);
+        phase_start = fc::time_point::now();
+        block_id_type head_block_id;
+        for (uint32_t block_num = 1; block_num <= block_count; ++block_num) {
+            signed_block block = make_block(block_num, head_block_id);
+            head_block_id = block.id();
+            producer.delegate->add_block(block);
+            tracker.originated(head_block_id);
+            producer.p2p_node->broadcast(block_message(block));
+            fc::usleep(fc::milliseconds(block_interval_ms));
+        }
+        bool blocks_delivered = wait_until([&]() {
+            return std::all_of(nodes.begin(), nodes.end(), [&](benchmark_node &n) {
+                return n.delegate->head_block_num() >= block_count;
+            });
+        }, phase_timeout);
+        uint64_t block_bytes = total_bytes_received(nodes) - bytes_before;
+        fc::mutable_variant_object block_latency;
+        {
+            std::lock_guard<std::mutex> lock(tracker.mutex);
+            block_latency = latency_summary(tracker.block_latencies);
+        }
+        report["blocks"] = fc::mutable_variant_object()
+                ("count", block_count)
+                ("delivered", blocks_delivered)
+                ("seconds", double((fc::time_point::now() - phase_start).count()) / 1000000)
+                ("latency", block_latency)
+                ("bytes_per_block", block_count ? block_bytes / block_count : 0);
+        success = success && blocks_delivered;
+        if (max_block_latency_ms && block_latency.find("p99_ms") != block_latency.end() &&
+            block_latency["p99_ms"].as_double() > max_block_latency_ms) {
+            success = false;
+        }
+
+        // sync, a fresh node fetches the whole chain from the producer, which also has blocks nobody else saw
+        for (uint32_t block_num = block_count + 1; block_num <= total_blocks; ++block_num) {
+            signed_block block = make_block(block_num, head_block_id);
+            head_block_id = block.id();
+            producer.delegate->add_block(block);
+        }
+        nodes.emplace_back();
+        benchmark_node &syncing = nodes.back();
+        start_node(syncing, node_count, data_dir.path(), tracker, genesis_time, node_count + 1);
+        phase_start = fc::time_point::now();
+        syncing.p2p_node->connect_to_endpoint(producer.endpoint);
+        bool synced = wait_until([&]() {
+            return syncing.delegate->head_block_num() >= total_blocks;
+        }, phase_timeout);
+        double sync_seconds = double((fc::time_point::now() - phase_start).count()) / 1000000;
+        report["sync"] = fc::mutable_variant_object()
+                ("blocks", total_blocks)
+                ("synced", synced)
+                ("seconds", sync_seconds)
+                ("blocks_per_second", sync_seconds > 0 ? syncing.delegate->head_block_num() / sync_seconds : 0);
+        success = success && synced;
+        if (max_sync_seconds && sync_seconds > max_sync_seconds) {
+            success = false;
+        }
+
+        report["success"] = success;
+        std::cout << fc::json::to_pretty_string(report) << "\n";
+
+        for (auto &n : nodes) {
+            stop_node(n);
+        }
+        message_oriented_connection::set_read_worker_thread_count(0);
+        return success ? 0 : 1;
+    }
+    catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << "\n";
+    }
+    catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+    }
+    return 1;
+}
@@ -0,0 +1,295 @@
+/**
+ *  Benchmark of the duplicate transaction check: compares the hashed by_trx_id index of transaction_index
+ *  with an ordered one in a chainbase shared memory file, and with an in-process hash set as a lower bound.
+ *
+ *  Each block inserts tps * block interval transactions in its own undo session after the dupe lookup,
+ *  then removes expired ones by expiration, and blocks become irreversible after --reversible-blocks,
+ *  the same way as database::_apply_transaction() and database::clear_expired_transactions() do.
+ *  The first --warmup-blocks fill the expiration window and aren't measured.
+ */
+
+#include <graphene/chain/chain_object_types.hpp>
+#include <graphene/protocol/config.hpp>
+
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <unordered_set>
+
+namespace bpo = boost::program_options;
+
+using graphene::chain::by_id;
+using graphene::chain::transaction_id_type;
+using fc::time_point_sec;
+
+namespace {
+    struct by_trx_id;
+    struct by_expiration;
+
+    enum benchmark_object_type {
+        hashed_dupe_object_type = 1000,
+        ordered_dupe_object_type
+    };
+
+    template<uint16_t TypeNumber>
+    class dupe_object final: public graphene::chain::object<TypeNumber, dupe_object<TypeNumber>> {
+    public:
+        template<typename Constructor, typename Allocator>
+        dupe_object(Constructor &&c, graphene::chain::allocator<Allocator>) {
+            c(*this);
+        }
+
+        graphene::chain::object_id<dupe_object<TypeNumber>> id;
+
+        transaction_id_type trx_id;
+        time_point_sec expiration;
+    };
+
+    using hashed_dupe_object = dupe_object<hashed_dupe_object_type>;
+    using ordered_dupe_object = dupe_object<ordered_dupe_object_type>;
+
+    using namespace boost::multi_index;
+
+    // the same as transaction_index
+    typedef multi_index_container<
+        hashed_dupe_object,
+        indexed_by<
+            ordered_unique<tag<by_id>, member<hashed_dupe_object, graphene::chain::object_id<hashed_dupe_object>, &hashed_dupe_object::id>>,
+            hashed_unique<tag<by_trx_id>, member<hashed_dupe_object, transaction_id_type, &hashed_dupe_object::trx_id>,
+                std::hash<transaction_id_type>>,
+            ordered_non_unique<tag<by_expiration>, member<hashed_dupe_object, time_point_sec, &hashed_dupe_object::expiration>>
+        >,
+        graphene::chain::allocator<hashed_dupe_object>
+    > hashed_dupe_index;
+
+    typedef multi_index_container<
+        ordered_dupe_object,
+        indexed_by<
+            ordered_unique<tag<by_id>, member<ordered_dupe_object, graphene::chain::object_id<ordered_dupe_object>, &ordered_dupe_object::id>>,
+            ordered_unique<tag<by_trx_id>, member<ordered_dupe_object, transaction_id_type, &ordered_dupe_object::trx_id>>,
+            ordered_non_unique<tag<by_expiration>, member<ordered_dupe_object, time_point_sec, &ordered_dupe_object::expiration>>
+        >,
+        graphene::chain::allocator<ordered_dupe_object>
+    > ordered_dupe_index;
+}
+
+CHAINBASE_SET_INDEX_TYPE(hashed_dupe_object, hashed_dupe_index)
+CHAINBASE_SET_INDEX_TYPE(ordered_dupe_object, ordered_dupe_index)
+
+namespace {
+    using clock_type = std::chrono::steady_clock;
+
+    struct benchmark_options {
+        uint32_t tps = 1000;
+        uint32_t blocks = 600;
+        uint32_t warmup_blocks = CHAIN_MAX_TIME_UNTIL_EXPIRATION / CHAIN_BLOCK_INTERVAL;
+        uint32_t reversible_blocks = 20;
+        uint64_t seed = 1;
+    };
+
+    /**
+     *  Generates the same transactions for every variant: random ids and expirations up to an hour ahead
+     */
+    class transaction_generator {
+    public:
+        explicit transaction_generator(uint64_t seed)
+                : _random(seed) {
+        }
+
+        std::pair<transaction_id_type, time_point_sec> next(time_point_sec now) {
+            transaction_id_type id;
+            for (size_t i = 0; i < id.data_size(); i += sizeof(uint64_t)) {
+                const uint64_t value = _random();
+                std::memcpy(id.data() + i, &value, std::min(sizeof(value), id.data_size() - i));
+            }
+            return std::make_pair(id, now + (1 + _random() % CHAIN_MAX_TIME_UNTIL_EXPIRATION));
+        }
+
+    private:
+        std::mt19937_64 _random;
+    };
+
+    struct variant_result {
+        std::vector<int64_t> block_times;
+        uint64_t objects = 0;
+        uint64_t used_memory = 0;
+    };
+
+    int64_t percentile(std::vector<int64_t> values, double p) {
+        if (values.empty()) {
+            return 0;
+        }
+        std::sort(values.begin(), values.end());
+        return values[std::min<size_t>(values.size() - 1, size_t(p * values.size()))];
+    }
+
+    fc::mutable_variant_object to_variant(const variant_result &result, const benchmark_options &options) {
+        int64_t total = 0;
+        for (auto t: result.block_times) {
+            total += t;
+        }
+        const auto transactions = uint64_t(options.tps) * CHAIN_BLOCK_INTERVAL * result.block_times.size();
+
+        fc::mutable_variant_object obj;
+        obj["blocks"] = result.block_times.size();
+        obj["objects"] = result.objects;
+        obj["used_memory"] = result.used_memory;
+        obj["block_us_avg"] = result.block_times.empty() ? 0 : total / int64_t(result.block_times.size());
+        obj["block_us_p50"] = percentile(result.block_times, 0.5);
+        obj["block_us_p99"] = percentile(result.block_times, 0.99);
+        obj["block_us_max"] = percentile(result.block_times, 1.0);
+        obj["ns_per_transaction"] = transactions ? total * 1000 / int64_t(transactions) : 0;
+        return obj;
+    }
+
+    template<typename MultiIndexType>
+    variant_result run_chainbase(const fc::path &dir, uint64_t file_size, const benchmark_options &options) {
+        using object_type = typename MultiIndexType::value_type;
+
+        fc::remove_all(dir);
+        chainbase::database db;
+        db.open(dir, chainbase::database::read_write, file_size);
+        db.add_index<MultiIndexType>();
+
+        transaction_generator generator(options.seed);
+        variant_result result;
+        time_point_sec now(CHAIN_BLOCK_INTERVAL);
+        const uint32_t per_block = options.tps * CHAIN_BLOCK_INTERVAL;
+
+        const auto &trx_idx = db.get_index<MultiIndexType>().indices().template get<by_trx_id>();
+        const auto &exp_idx = db.get_index<MultiIndexType>().indices().template get<by_expiration>();
+
+        for (uint32_t block = 1; block <= options.warmup_blocks + options.blocks; ++block) {
+            auto start = clock_type::now();
+
+            auto session = db.start_undo_session();
+            for (uint32_t i = 0; i < per_block; ++i) {
+                auto trx = generator.next(now);
+                FC_ASSERT(trx_idx.find(trx.first) == trx_idx.end(), "Duplicate transaction");
+                db.template create<object_type>([&](object_type &o) {
+                    o.trx_id = trx.first;
+                    o.expiration = trx.second;
+                });
+            }
+            while (!exp_idx.empty() && now > exp_idx.begin()->expiration) {
+                db.remove(*exp_idx.begin());
+            }
+            session.push();
+
+            if (block > options.reversible_blocks) {
+                db.commit(block - options.reversible_blocks);
+            }
+
+            auto end = clock_type::now();
+            if (block > options.warmup_blocks) {
+                result.block_times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+            }
+            now += CHAIN_BLOCK_INTERVAL;
+        }
+
+        result.objects = trx_idx.size();
+        result.used_memory = db.max_memory() - db.free_memory();
+
+        db.close();
+        fc::remove_all(dir);
+        return result;
+    }
+
+    /**
+     *  An expiring hash set in process memory, it has no undo and would be rebuilt from the last hour of blocks on startup
+     */
+    variant_result run_process_hash_set(const benchmark_options &options) {
+        std::unordered_set<transaction_id_type> ids;
+        std::multimap<time_point_sec, transaction_id_type> expirations;
+
+        transaction_generator generator(options.seed);
+        variant_result result;
+        time_point_sec now(CHAIN_BLOCK_INTERVAL);
+        const uint32_t per_block = options.tps * CHAIN_BLOCK_INTERVAL;
+
+        for (uint32_t block = 1; block <= options.warmup_blocks + options.blocks; ++block) {
+            auto start = clock_type::now();
+
+            for (uint32_t i = 0; i < per_block; ++i) {
+                auto trx = generator.next(now);
+                FC_ASSERT(ids.insert(trx.first).second, "Duplicate transaction");
+                expirations.emplace(trx.second, trx.first);
+            }
+            while (!expirations.empty() && now > expirations.begin()->first) {
+                ids.erase(expirations.begin()->second);
+                expirations.erase(expirations.begin());
+            }
+
+            auto end = clock_type::now();
+            if (block > options.warmup_blocks) {
+                result.block_times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+            }
+            now += CHAIN_BLOCK_INTERVAL;
+        }
+
+        result.objects = ids.size();
+        return result;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        benchmark_options options;
+
+        bpo::options_description cli("benchmark_dupe_check options");
+        cli.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("dir", bpo::value<std::string>()->default_value("benchmark_dupe_check"),
+                "directory of temporary shared memory files, it's removed after the run")
+            ("shared-file-size", bpo::value<uint64_t>()->default_value(8ull * 1024 * 1024 * 1024),
+                "size of each shared memory file in bytes")
+            ("tps", bpo::value<uint32_t>(&options.tps)->default_value(options.tps),
+                "transactions per second")
+            ("blocks", bpo::value<uint32_t>(&options.blocks)->default_value(options.blocks),
+                "number of measured blocks")
+            ("warmup-blocks", bpo::value<uint32_t>(&options.warmup_blocks)->default_value(options.warmup_blocks),
+                "number of blocks which fill the expiration window before measuring")
+            ("reversible-blocks", bpo::value<uint32_t>(&options.reversible_blocks)->default_value(options.reversible_blocks),
+                "number of blocks which undo sessions are kept")
+            ("seed", bpo::value<uint64_t>(&options.seed)->default_value(options.seed),
+                "seed of generated transactions");
+
+        bpo::variables_map vm;
+        bpo::store(bpo::parse_command_line(argc, argv, cli), vm);
+        bpo::notify(vm);
+
+        if (vm.count("help")) {
+            std::cout << cli << std::endl;
+            return 0;
+        }
+
+        const fc::path dir = vm.at("dir").as<std::string>();
+        const auto file_size = vm.at("shared-file-size").as<uint64_t>();
+
+        fc::mutable_variant_object result;
+        result["tps"] = options.tps;
+        result["hashed_by_trx_id"] = to_variant(run_chainbase<hashed_dupe_index>(dir / "hashed", file_size, options), options);
+        result["ordered_by_trx_id"] = to_variant(run_chainbase<ordered_dupe_index>(dir / "ordered", file_size, options), options);
+        result["process_hash_set"] = to_variant(run_process_hash_set(options), options);
+
+        std::cout << fc::json::to_pretty_string(result) << std::endl;
+    } catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
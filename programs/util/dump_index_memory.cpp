@@ -0,0 +1,101 @@
+/**
+ * Prints bytes of the shared memory file taken by each index of a stopped node.
+ *
+ * Indexes of plugins exist in the file only if the plugins were enabled,
+ * so they should be listed with --plugin the same way as in config.ini.
+ */
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/index_memory_usage.hpp>
+
+#include <graphene/plugins/account_by_key/account_by_key_plugin.hpp>
+#include <graphene/plugins/account_history/plugin.hpp>
+#include <graphene/plugins/follow/plugin.hpp>
+#include <graphene/plugins/operation_history/plugin.hpp>
+#include <graphene/plugins/private_message/private_message_plugin.hpp>
+#include <graphene/plugins/tags/plugin.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <map>
+
+namespace bpo = boost::program_options;
+
+using graphene::chain::database;
+using graphene::chain::index_memory_usage;
+
+namespace {
+    using namespace graphene::plugins;
+
+    // indexes are registered by the plugins themselves, so the list doesn't drift from them
+    const std::map<std::string, std::function<void(database &)>> plugin_indexes = {
+        {"account_by_key", &account_by_key::register_indexes},
+        {"account_history", &account_history::register_indexes},
+        {"follow", &follow::register_indexes},
+        {"operation_history", &operation_history::register_indexes},
+        {"private_message", &private_message::register_indexes},
+        {"tags", &tags::register_indexes},
+    };
+}
+
+int main(int argc, char **argv) {
+    try {
+        bpo::options_description cli("dump_index_memory options");
+        cli.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("shared-file-dir", bpo::value<std::string>()->default_value("blockchain"),
+                "the location of the chain shared memory files")
+            ("plugin", bpo::value<std::vector<std::string>>()->composing(),
+                "plugin which indexes are in the shared memory file (account_by_key, account_history, follow, "
+                "operation_history, private_message, tags), may be specified multiple times")
+            ("objects-per-lock", bpo::value<uint32_t>()->default_value(10000),
+                "number of objects walked at once");
+
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(argc, argv, cli), options);
+        bpo::notify(options);
+
+        if (options.count("help")) {
+            std::cout << cli << std::endl;
+            return 0;
+        }
+
+        database db;
+
+        if (options.count("plugin")) {
+            for (const auto &name: options.at("plugin").as<std::vector<std::string>>()) {
+                auto itr = plugin_indexes.find(name);
+                FC_ASSERT(itr != plugin_indexes.end(), "Plugin ${name} has no indexes", ("name", name));
+                itr->second(db);
+            }
+        }
+
+        db.open(fc::path(), options.at("shared-file-dir").as<std::string>(), CHAIN_INIT_SUPPLY, 0,
+                chainbase::database::read_only);
+
+        auto indexes = db.get_index_memory_usage(options.at("objects-per-lock").as<uint32_t>());
+        std::sort(indexes.begin(), indexes.end(), [](const index_memory_usage &a, const index_memory_usage &b) {
+            return a.total_size > b.total_size;
+        });
+
+        fc::mutable_variant_object result;
+        result["total_size"] = db.max_memory();
+        result["free_size"] = db.free_memory();
+        result["used_size"] = db.max_memory() - db.free_memory();
+        result["indexes"] = indexes;
+
+        std::cout << fc::json::to_pretty_string(result) << std::endl;
+    } catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}